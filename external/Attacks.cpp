@@ -0,0 +1,136 @@
+#include "Attacks.hpp"
+#include <vector>
+
+std::array<Magic, 64> rookMagics;
+std::array<Magic, 64> bishopMagics;
+std::array<std::array<Bitboard, 64>, 64> betweenTable;
+std::array<std::array<Bitboard, 64>, 64> lineTable;
+
+// Attack tables shared by every square, 0x19000 rook and 0x1480 bishop entries
+static std::vector<Bitboard> rookTable(0x19000);
+static std::vector<Bitboard> bishopTable(0x1480);
+
+constexpr std::array<std::array<int, 2>, 4> rookDirections = {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+constexpr std::array<std::array<int, 2>, 4> bishopDirections = {{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+
+// Walk each ray until it leaves the board or hits a blocker
+static Bitboard slidingAttacks(int square, Bitboard occupied,
+                               const std::array<std::array<int, 2>, 4> &directions) {
+    Bitboard attacks = 0;
+    for (auto direction : directions) {
+        int row = rowOf(square) + direction[0];
+        int col = colOf(square) + direction[1];
+        while (row >= 0 && row < 8 && col >= 0 && col < 8) {
+            Bitboard bit = squareBit(squareIndex(row, col));
+            attacks |= bit;
+            if (occupied & bit) {
+                break;
+            }
+            row += direction[0];
+            col += direction[1];
+        }
+    }
+    return attacks;
+}
+
+#if !defined(__BMI2__)
+// Deterministic xorshift generator, so startup always finds the same magics
+static Bitboard nextRandom(Bitboard &state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+#endif
+
+static void initMagics(std::array<Magic, 64> &magics, Bitboard *table,
+                       const std::array<std::array<int, 2>, 4> &directions) {
+    std::vector<Bitboard> occupancies(4096);
+    std::vector<Bitboard> references(4096);
+#if !defined(__BMI2__)
+    std::vector<int> epoch(4096, 0);
+    Bitboard state = 728;
+    int attempt = 0;
+#endif
+
+    for (int square = 0; square < 64; square++) {
+        Magic &magic = magics[square];
+
+        // Board edges never block a ray, so they're left out of the mask
+        Bitboard edges = ((rank1 | rank8) & ~(rank1 << (8 * rowOf(square)))) |
+                         ((fileA | fileH) & ~(fileA << colOf(square)));
+        magic.mask = slidingAttacks(square, 0, directions) & ~edges;
+        magic.shift = 64 - __builtin_popcountll(magic.mask);
+        magic.attacks = table;
+
+        // Enumerate every subset of the mask with the carry-rippler trick
+        int size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancies[size] = subset;
+            references[size] = slidingAttacks(square, subset, directions);
+#if defined(__BMI2__)
+            table[_pext_u64(subset, magic.mask)] = references[size];
+#endif
+            size++;
+            subset = (subset - magic.mask) & magic.mask;
+        } while (subset);
+
+#if !defined(__BMI2__)
+        // Try sparse random candidates until one maps every subset without a
+        // destructive collision
+        bool found = false;
+        while (!found) {
+            do {
+                magic.magic = nextRandom(state) & nextRandom(state) & nextRandom(state);
+            } while (__builtin_popcountll((magic.magic * magic.mask) >> 56) < 6);
+
+            attempt++;
+            found = true;
+            for (int i = 0; i < size; i++) {
+                unsigned index = magic.index(occupancies[i]);
+                if (epoch[index] < attempt) {
+                    epoch[index] = attempt;
+                    table[index] = references[i];
+                } else if (table[index] != references[i]) {
+                    found = false;
+                    break;
+                }
+            }
+        }
+#endif
+
+        table += size;
+    }
+}
+
+static void initLines() {
+    for (int from = 0; from < 64; from++) {
+        for (int to = 0; to < 64; to++) {
+            betweenTable[from][to] = 0;
+            lineTable[from][to] = 0;
+            if (from == to) {
+                continue;
+            }
+            if (rookAttacks(from, 0) & squareBit(to)) {
+                lineTable[from][to] = (rookAttacks(from, 0) & rookAttacks(to, 0)) |
+                                      squareBit(from) | squareBit(to);
+                betweenTable[from][to] = rookAttacks(from, squareBit(to)) &
+                                         rookAttacks(to, squareBit(from));
+            } else if (bishopAttacks(from, 0) & squareBit(to)) {
+                lineTable[from][to] = (bishopAttacks(from, 0) & bishopAttacks(to, 0)) |
+                                      squareBit(from) | squareBit(to);
+                betweenTable[from][to] = bishopAttacks(from, squareBit(to)) &
+                                         bishopAttacks(to, squareBit(from));
+            }
+        }
+    }
+}
+
+// Tables are filled during static initialisation, before main runs
+static const bool attacksInitialised = [] {
+    initMagics(rookMagics, rookTable.data(), rookDirections);
+    initMagics(bishopMagics, bishopTable.data(), bishopDirections);
+    initLines();
+    return true;
+}();
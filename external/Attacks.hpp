@@ -0,0 +1,103 @@
+#ifndef Attacks_hpp
+#define Attacks_hpp
+
+#include "Types.hpp"
+#include <array>
+#include <cstddef>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+constexpr Bitboard fileA = 0x0101010101010101ULL;
+constexpr Bitboard fileH = fileA << 7;
+constexpr Bitboard rank1 = 0xFFULL;
+constexpr Bitboard rank3 = rank1 << 16;
+constexpr Bitboard rank6 = rank1 << 40;
+constexpr Bitboard rank8 = rank1 << 56;
+
+// Attacks of leaper pieces from each square, built at compile time
+template <std::size_t N>
+constexpr std::array<Bitboard, 64> makeLeaperTable(std::array<std::array<int, 2>, N> steps) {
+    std::array<Bitboard, 64> table = {};
+    for (int square = 0; square < 64; square++) {
+        for (auto step : steps) {
+            int row = rowOf(square) + step[0];
+            int col = colOf(square) + step[1];
+            if (row >= 0 && row < 8 && col >= 0 && col < 8) {
+                table[square] |= squareBit(squareIndex(row, col));
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr std::array<Bitboard, 64> knightTable = makeLeaperTable<8>(
+    {{{2, 1}, {1, 2}, {-1, 2}, {-2, 1}, {-2, -1}, {-1, -2}, {1, -2}, {2, -1}}});
+
+inline constexpr std::array<Bitboard, 64> kingTable = makeLeaperTable<8>(
+    {{{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}}});
+
+// Squares a pawn of each colour attacks, indexed by pieceColor
+inline constexpr std::array<std::array<Bitboard, 64>, 2> pawnTable = {
+    makeLeaperTable<2>({{{1, -1}, {1, 1}}}),
+    makeLeaperTable<2>({{{-1, -1}, {-1, 1}}})};
+
+// Sliding attacks are looked up in tables indexed by the relevant blockers,
+// either with PEXT where available or with magic multiplication
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    const Bitboard *attacks;
+    unsigned shift;
+
+    unsigned index(Bitboard occupied) const {
+#if defined(__BMI2__)
+        return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+        return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+extern std::array<Magic, 64> rookMagics;
+extern std::array<Magic, 64> bishopMagics;
+
+// Squares strictly between two aligned squares, and the full line through
+// them. Both are empty for squares that don't share a line
+extern std::array<std::array<Bitboard, 64>, 64> betweenTable;
+extern std::array<std::array<Bitboard, 64>, 64> lineTable;
+
+inline Bitboard knightAttacks(int square) { return knightTable[square]; }
+
+inline Bitboard kingAttacks(int square) { return kingTable[square]; }
+
+inline Bitboard pawnAttacks(pieceColor color, int square) {
+    return pawnTable[colorIndex(color)][square];
+}
+
+inline Bitboard rookAttacks(int square, Bitboard occupied) {
+    const Magic &magic = rookMagics[square];
+    return magic.attacks[magic.index(occupied)];
+}
+
+inline Bitboard bishopAttacks(int square, Bitboard occupied) {
+    const Magic &magic = bishopMagics[square];
+    return magic.attacks[magic.index(occupied)];
+}
+
+inline Bitboard queenAttacks(int square, Bitboard occupied) {
+    return rookAttacks(square, occupied) | bishopAttacks(square, occupied);
+}
+
+inline Bitboard between(int from, int to) { return betweenTable[from][to]; }
+
+inline Bitboard line(int from, int to) { return lineTable[from][to]; }
+
+inline int popLowest(Bitboard &bitboard) {
+    int square = __builtin_ctzll(bitboard);
+    bitboard &= bitboard - 1;
+    return square;
+}
+
+#endif
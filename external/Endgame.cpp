@@ -0,0 +1,207 @@
+#include "Endgame.hpp"
+#include "Attacks.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+// King and pawn against king positions with white's pawn on files a to d,
+// every other position is a mirror image of one of them. Indexed by side to
+// move, pawn square, white king and black king
+constexpr int kpkSize = 2 * 24 * 64 * 64;
+
+static int kpkIndex(int whiteKing, int pawn, int blackKing, pieceColor sideToMove) {
+    int pawnIndex = (rowOf(pawn) - 1) * 4 + colOf(pawn);
+    return ((colorIndex(sideToMove) * 24 + pawnIndex) * 64 + whiteKing) * 64 + blackKing;
+}
+
+// Results while the bitbase is built, those of every move from a position
+// are ored together so one bit per result is enough to tell them apart
+enum : std::uint8_t { kpkInvalid = 0, kpkUnknown = 1, kpkDraw = 2, kpkWin = 4 };
+
+static int distance(int from, int to) {
+    return std::max(std::abs(rowOf(from) - rowOf(to)), std::abs(colOf(from) - colOf(to)));
+}
+
+// Results that follow from the position itself, without looking at moves
+static std::uint8_t classifyKpk(int whiteKing, int pawn, int blackKing, pieceColor sideToMove) {
+    if (distance(whiteKing, blackKing) <= 1 || whiteKing == pawn || blackKing == pawn ||
+        (sideToMove == pieceColor::white &&
+         (pawnAttacks(pieceColor::white, pawn) & squareBit(blackKing)))) {
+        return kpkInvalid;
+    }
+
+    int push = pawn + 8;
+    if (sideToMove == pieceColor::white) {
+        // Promotes and the new queen can't be taken
+        if (rowOf(pawn) == 6 && push != whiteKing && push != blackKing &&
+            (distance(blackKing, push) > 1 || distance(whiteKing, push) == 1)) {
+            return kpkWin;
+        }
+    } else {
+        // Stalemated, or takes the pawn when it isn't protected
+        Bitboard safe = kingAttacks(blackKing) &
+                        ~(kingAttacks(whiteKing) | pawnAttacks(pieceColor::white, pawn));
+        if (!safe || (safe & squareBit(pawn))) {
+            return kpkDraw;
+        }
+    }
+    return kpkUnknown;
+}
+
+// White wins if any move wins, black draws if any move draws. Moves into an
+// illegal position add nothing
+static std::uint8_t solveKpk(const std::vector<std::uint8_t> &results, int whiteKing, int pawn,
+                             int blackKing, pieceColor sideToMove) {
+    std::uint8_t reached = 0;
+    std::uint8_t good;
+    std::uint8_t bad;
+    if (sideToMove == pieceColor::white) {
+        good = kpkWin;
+        bad = kpkDraw;
+        Bitboard moves = kingAttacks(whiteKing);
+        while (moves) {
+            reached |= results[kpkIndex(popLowest(moves), pawn, blackKing, pieceColor::black)];
+        }
+        int push = pawn + 8;
+        if (rowOf(pawn) < 6 && push != whiteKing && push != blackKing) {
+            reached |= results[kpkIndex(whiteKing, push, blackKing, pieceColor::black)];
+            if (rowOf(pawn) == 1 && push + 8 != whiteKing && push + 8 != blackKing) {
+                reached |= results[kpkIndex(whiteKing, push + 8, blackKing, pieceColor::black)];
+            }
+        }
+    } else {
+        good = kpkDraw;
+        bad = kpkWin;
+        Bitboard moves = kingAttacks(blackKing);
+        while (moves) {
+            reached |= results[kpkIndex(whiteKing, pawn, popLowest(moves), pieceColor::white)];
+        }
+    }
+    if (reached & good) {
+        return good;
+    }
+    return (reached & kpkUnknown) ? std::uint8_t(kpkUnknown) : bad;
+}
+
+// Retrograde analysis: settle what can be seen directly, then keep passing
+// over the unsettled positions until none of them changes. Whatever is
+// still unknown at the end is a draw
+static std::vector<std::uint64_t> buildKpkBitbase() {
+    std::vector<std::uint8_t> results(kpkSize);
+    for (auto side : {pieceColor::white, pieceColor::black}) {
+        for (int pawnIndex = 0; pawnIndex < 24; pawnIndex++) {
+            int pawn = squareIndex(pawnIndex / 4 + 1, pawnIndex % 4);
+            for (int whiteKing = 0; whiteKing < 64; whiteKing++) {
+                for (int blackKing = 0; blackKing < 64; blackKing++) {
+                    results[kpkIndex(whiteKing, pawn, blackKing, side)] =
+                        classifyKpk(whiteKing, pawn, blackKing, side);
+                }
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto side : {pieceColor::white, pieceColor::black}) {
+            for (int pawnIndex = 0; pawnIndex < 24; pawnIndex++) {
+                int pawn = squareIndex(pawnIndex / 4 + 1, pawnIndex % 4);
+                for (int whiteKing = 0; whiteKing < 64; whiteKing++) {
+                    for (int blackKing = 0; blackKing < 64; blackKing++) {
+                        std::uint8_t &result = results[kpkIndex(whiteKing, pawn, blackKing, side)];
+                        if (result == kpkUnknown) {
+                            result = solveKpk(results, whiteKing, pawn, blackKing, side);
+                            changed |= result != kpkUnknown;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<std::uint64_t> bitbase(kpkSize / 64);
+    for (int index = 0; index < kpkSize; index++) {
+        if (results[index] == kpkWin) {
+            bitbase[index / 64] |= std::uint64_t(1) << (index % 64);
+        }
+    }
+    return bitbase;
+}
+
+// One bit per position, 24KB, built once when the program starts
+static const std::vector<std::uint64_t> kpkBitbase = buildKpkBitbase();
+
+bool kpkWins(int whiteKing, int pawn, int blackKing, pieceColor sideToMove) {
+    int index = kpkIndex(whiteKing, pawn, blackKing, sideToMove);
+    return (kpkBitbase[index / 64] >> (index % 64)) & 1;
+}
+
+// Rewards the winning side for driving the lone king to the edge and
+// bringing its own king close, which is how these endings are won
+static float mateProgress(int strongKing, int weakKing) {
+    int edgeDistance = std::min({rowOf(weakKing), 7 - rowOf(weakKing), colOf(weakKing),
+                                 7 - colOf(weakKing)});
+    return (3 - edgeDistance) * 10 + (7 - distance(strongKing, weakKing)) * 2;
+}
+
+endgameResult probeEndgame(const Position &position, float &score) {
+    Bitboard occupied = position.pieces();
+    int pieceCount = __builtin_popcountll(occupied);
+    if (pieceCount > 3) {
+        return endgameResult::unknown;
+    }
+
+    score = 0;
+    Bitboard others = occupied & ~position.pieces(pieceType::King);
+    if (!others) {
+        return endgameResult::draw;
+    }
+
+    int square = __builtin_ctzll(others);
+    pieceType type = position.pieceOn(square);
+    pieceColor strong = position.colorOn(square);
+    int strongKing = position.kingSquare(strong);
+    int weakKing = position.kingSquare(opposite(strong));
+    if (strongKing == noSquare || weakKing == noSquare) {
+        return endgameResult::unknown;
+    }
+    float sign = strong == pieceColor::white ? 1 : -1;
+
+    switch (type) {
+        case pieceType::Knight:
+        case pieceType::Bishop:
+            return endgameResult::draw;
+        case pieceType::Queen:
+        case pieceType::Rook:
+            score = sign * (knownWinScore + pieceValue[typeIndex(type)] +
+                            mateProgress(strongKing, weakKing));
+            return endgameResult::win;
+        case pieceType::Pawn: {
+            // Seen from the side with the pawn, with the pawn on files a to d
+            pieceColor sideToMove = position.getSideToMove();
+            if (strong == pieceColor::black) {
+                square ^= 56;
+                strongKing ^= 56;
+                weakKing ^= 56;
+                sideToMove = opposite(sideToMove);
+            }
+            // Only reachable from a hand-made position, the bitbase has no
+            // pawns on the first or last rank
+            if (rowOf(square) == 0 || rowOf(square) == 7) {
+                return endgameResult::unknown;
+            }
+            if (colOf(square) > 3) {
+                square ^= 7;
+                strongKing ^= 7;
+                weakKing ^= 7;
+            }
+            if (!kpkWins(strongKing, square, weakKing, sideToMove)) {
+                return endgameResult::draw;
+            }
+            score = sign * (knownWinScore + pieceValue[typeIndex(type)] + rowOf(square) * 5);
+            return endgameResult::win;
+        }
+        default:
+            return endgameResult::unknown;
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef Endgame_hpp
+#define Endgame_hpp
+
+#include "Position.hpp"
+
+// Added to the score of a won endgame, far above any material balance the
+// evaluation produces and far below mateScore
+constexpr float knownWinScore = 10000;
+
+enum class endgameResult {
+    // Not an endgame this module knows
+    unknown,
+    // Exact, no amount of searching changes it
+    draw,
+    // Won for the side with the extra piece, the score only steers the
+    // search towards mate so it still has to be searched
+    win
+};
+
+// Recognises bare kings, a lone minor piece, and king and queen, king and
+// rook or king and pawn against king. score is set from white's point of
+// view, like Position::evaluate, for anything but unknown
+endgameResult probeEndgame(const Position &position, float &score);
+
+// Whether white wins with king and pawn against king, from the bitbase
+// built at startup. Pawn is white and on files a to d
+bool kpkWins(int whiteKing, int pawn, int blackKing, pieceColor sideToMove);
+
+#endif
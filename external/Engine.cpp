@@ -0,0 +1,90 @@
+#include "Engine.hpp"
+
+Engine::Engine(std::function<void(const SearchResult &)> pOnIteration,
+               std::function<void(const SearchResult &)> pOnFinished) {
+    finished = false;
+    busy = false;
+    onIteration = pOnIteration;
+    onFinished = pOnFinished;
+    control.onIteration = [this](const SearchResult &result) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            progress = result;
+        }
+        if (onIteration) {
+            onIteration(result);
+        }
+    };
+}
+
+Engine::~Engine() { this->cancel(); }
+
+// Any search still running is abandoned first
+void Engine::start(const Position &position, const SearchLimits &limits) {
+    this->cancel();
+    control.stop = false;
+    progress = SearchResult();
+    finished = false;
+    busy = true;
+    worker = std::thread([this, position, limits]() {
+        SearchResult result = searchPosition(position, limits, &control);
+        if (limits.infinite) {
+            control.stop.wait(false);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            progress = result;
+            finished = true;
+        }
+        if (onFinished) {
+            onFinished(result);
+        }
+    });
+}
+
+bool Engine::isBusy() { return busy; }
+
+// True once, when the search has finished, handing over its result
+bool Engine::poll(SearchResult &result) {
+    if (!busy) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!finished) {
+            return false;
+        }
+    }
+    result = this->wait();
+    return true;
+}
+
+// Block until the search finishes and collect its result
+SearchResult Engine::wait() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+    busy = false;
+    return progress;
+}
+
+// Depth, score and line of the deepest iteration finished so far
+SearchResult Engine::getProgress() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return progress;
+}
+
+// Finish early, the best move found so far can still be collected
+void Engine::stop() {
+    control.stop = true;
+    control.stop.notify_all();
+}
+
+// Stop and throw away the result
+void Engine::cancel() {
+    this->stop();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    busy = false;
+}
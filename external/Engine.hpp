@@ -0,0 +1,42 @@
+#ifndef Engine_hpp
+#define Engine_hpp
+
+#include "Opponent.hpp"
+#include "Position.hpp"
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Runs one search at a time on a background thread so the caller never
+// blocks. Start a search on a copy of a position, then poll until the
+// result arrives, or cancel it if the position is no longer wanted.
+// Callers that would rather be told can pass callbacks for every finished
+// iteration and for the final result
+class Engine {
+  private:
+    std::thread worker;
+    SearchControl control;
+    std::mutex mutex;
+    // Latest completed iteration, the final result once finished is set
+    SearchResult progress;
+    bool finished;
+    // Started and result not yet collected, only touched by the caller
+    bool busy;
+    // Optional, called on the search thread
+    std::function<void(const SearchResult &)> onIteration;
+    std::function<void(const SearchResult &)> onFinished;
+
+  public:
+    Engine(std::function<void(const SearchResult &)> pOnIteration = nullptr,
+           std::function<void(const SearchResult &)> pOnFinished = nullptr);
+    ~Engine();
+    void start(const Position &position, const SearchLimits &limits);
+    bool isBusy();
+    bool poll(SearchResult &result);
+    SearchResult wait();
+    SearchResult getProgress();
+    void stop();
+    void cancel();
+};
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef Evaluation_hpp
+#define Evaluation_hpp
+
+#include "Types.hpp"
+#include <array>
+
+// Material in pawns x 10, indexed by pieceType. Both kings are always on the
+// board so the king's material cancels out
+inline constexpr std::array<float, 7> pieceValue = {0, 10, 50, 30, 30, 0, 90};
+
+// Piece square tables from white's point of view, indexed by [row][col]
+// with row 0 as white's back rank. Black uses them mirrored vertically
+using PieceSquareTable = std::array<std::array<float, 8>, 8>;
+
+inline constexpr PieceSquareTable pawnSquares = {{
+    { 0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0},
+    { 0.5,  1.0,  1.0, -2.0, -2.0,  1.0,  1.0,  0.5},
+    { 0.5, -0.5, -1.0,  0.0,  0.0, -1.0, -0.5,  0.5},
+    { 0.0,  0.0,  0.0,  2.0,  2.0,  0.0,  0.0,  0.0},
+    { 0.5,  0.5,  1.0,  2.5,  2.5,  1.0,  0.5,  0.5},
+    { 1.0,  1.0,  2.0,  3.0,  3.0,  2.0,  1.0,  1.0},
+    { 5.0,  5.0,  5.0,  5.0,  5.0,  5.0,  5.0,  5.0},
+    { 0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0},
+}};
+
+inline constexpr PieceSquareTable knightSquares = {{
+    {-5.0, -4.0, -3.0, -3.0, -3.0, -3.0, -4.0, -5.0},
+    {-4.0, -2.0,  0.0,  0.5,  0.5,  0.0, -2.0, -4.0},
+    {-3.0,  0.5,  1.0,  1.5,  1.5,  1.0,  0.5, -3.0},
+    {-3.0,  0.0,  1.5,  2.0,  2.0,  1.5,  0.0, -3.0},
+    {-3.0,  0.5,  1.5,  2.0,  2.0,  1.5,  0.5, -3.0},
+    {-3.0,  0.0,  1.0,  1.5,  1.5,  1.0,  0.0, -3.0},
+    {-4.0, -2.0,  0.0,  0.0,  0.0,  0.0, -2.0, -4.0},
+    {-5.0, -4.0, -3.0, -3.0, -3.0, -3.0, -4.0, -5.0},
+}};
+
+inline constexpr PieceSquareTable bishopSquares = {{
+    {-2.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -2.0},
+    {-1.0,  0.5,  0.0,  0.0,  0.0,  0.0,  0.5, -1.0},
+    {-1.0,  1.0,  1.0,  1.0,  1.0,  1.0,  1.0, -1.0},
+    {-1.0,  0.0,  1.0,  1.0,  1.0,  1.0,  0.0, -1.0},
+    {-1.0,  0.5,  0.5,  1.0,  1.0,  0.5,  0.5, -1.0},
+    {-1.0,  0.0,  0.5,  1.0,  1.0,  0.5,  0.0, -1.0},
+    {-1.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -1.0},
+    {-2.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -2.0},
+}};
+
+inline constexpr PieceSquareTable rookSquares = {{
+    { 0.0,  0.0,  0.0,  0.5,  0.5,  0.0,  0.0,  0.0},
+    {-0.5,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -0.5},
+    {-0.5,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -0.5},
+    {-0.5,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -0.5},
+    {-0.5,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -0.5},
+    {-0.5,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -0.5},
+    { 0.5,  1.0,  1.0,  1.0,  1.0,  1.0,  1.0,  0.5},
+    { 0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0},
+}};
+
+inline constexpr PieceSquareTable queenSquares = {{
+    {-2.0, -1.0, -1.0, -0.5, -0.5, -1.0, -1.0, -2.0},
+    {-1.0,  0.0,  0.5,  0.0,  0.0,  0.0,  0.0, -1.0},
+    {-1.0,  0.5,  0.5,  0.5,  0.5,  0.5,  0.0, -1.0},
+    { 0.0,  0.0,  0.5,  0.5,  0.5,  0.5,  0.0, -0.5},
+    {-0.5,  0.0,  0.5,  0.5,  0.5,  0.5,  0.0, -0.5},
+    {-1.0,  0.0,  0.5,  0.5,  0.5,  0.5,  0.0, -1.0},
+    {-1.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -1.0},
+    {-2.0, -1.0, -1.0, -0.5, -0.5, -1.0, -1.0, -2.0},
+}};
+
+inline constexpr PieceSquareTable kingMiddlegameSquares = {{
+    { 2.0,  3.0,  1.0,  0.0,  0.0,  1.0,  3.0,  2.0},
+    { 2.0,  2.0,  0.0,  0.0,  0.0,  0.0,  2.0,  2.0},
+    {-1.0, -2.0, -2.0, -2.0, -2.0, -2.0, -2.0, -1.0},
+    {-2.0, -3.0, -3.0, -4.0, -4.0, -3.0, -3.0, -2.0},
+    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
+    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
+    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
+    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
+}};
+
+// Kings should head for the centre once the queens and rooks are gone
+inline constexpr PieceSquareTable kingEndgameSquares = {{
+    {-5.0, -3.0, -3.0, -3.0, -3.0, -3.0, -3.0, -5.0},
+    {-3.0, -3.0,  0.0,  0.0,  0.0,  0.0, -3.0, -3.0},
+    {-3.0, -1.0,  2.0,  3.0,  3.0,  2.0, -1.0, -3.0},
+    {-3.0, -1.0,  3.0,  4.0,  4.0,  3.0, -1.0, -3.0},
+    {-3.0, -1.0,  3.0,  4.0,  4.0,  3.0, -1.0, -3.0},
+    {-3.0, -1.0,  2.0,  3.0,  3.0,  2.0, -1.0, -3.0},
+    {-3.0, -2.0, -1.0,  0.0,  0.0, -1.0, -2.0, -3.0},
+    {-5.0, -4.0, -3.0, -2.0, -2.0, -3.0, -4.0, -5.0},
+}};
+
+// Game phase contributed by each pieceType. The full starting set of
+// minor and major pieces adds up to maxPhase, the middlegame
+inline constexpr std::array<int, 7> phaseWeight = {0, 0, 2, 1, 1, 0, 4};
+inline constexpr int maxPhase = 24;
+
+struct TaperedScore {
+    float middlegame = 0;
+    float endgame = 0;
+};
+
+// Material plus table bonus of every piece on every square, positive for
+// white and negative for black, indexed by [pieceColor][pieceType][square]
+constexpr std::array<std::array<std::array<TaperedScore, 64>, 7>, 2> makePieceSquareScores() {
+    std::array<std::array<std::array<TaperedScore, 64>, 7>, 2> scores = {};
+    for (int square = 0; square < 64; square++) {
+        for (auto color : {pieceColor::white, pieceColor::black}) {
+            int row = color == pieceColor::white ? rowOf(square) : 7 - rowOf(square);
+            int col = colOf(square);
+            float sign = color == pieceColor::white ? 1 : -1;
+            auto set = [&](pieceType type, float middlegame, float endgame) {
+                TaperedScore &score = scores[colorIndex(color)][typeIndex(type)][square];
+                score.middlegame = sign * (pieceValue[typeIndex(type)] + middlegame);
+                score.endgame = sign * (pieceValue[typeIndex(type)] + endgame);
+            };
+            set(pieceType::Pawn, pawnSquares[row][col], pawnSquares[row][col]);
+            set(pieceType::Knight, knightSquares[row][col], knightSquares[row][col]);
+            set(pieceType::Bishop, bishopSquares[row][col], bishopSquares[row][col]);
+            set(pieceType::Rook, rookSquares[row][col], rookSquares[row][col]);
+            set(pieceType::Queen, queenSquares[row][col], queenSquares[row][col]);
+            set(pieceType::King, kingMiddlegameSquares[row][col], kingEndgameSquares[row][col]);
+        }
+    }
+    return scores;
+}
+
+inline constexpr auto pieceSquareScores = makePieceSquareScores();
+
+#endif
@@ -2,27 +2,33 @@
 #define Game_hpp
 
 #include "Board.hpp"
-#include "Piece.hpp"
+#include "Position.hpp"
 #include "Square.hpp"
+#include <vector>
 
 enum class opponents {computer, player};
 
+// Entry in the previous moves stack
+struct MoveRecord {
+    Move move;
+    UndoInfo undo;
+    gameStatus status;
+};
+
 class Game : public std::enable_shared_from_this<Game> {
   private:
-    pieceColor currentTurn;
     gameStatus status;
     opponents opponent;
     std::shared_ptr<Board> board;
     // Previous moves stack
-    // start, end, pieceMoved, pieceTaken, castlingMove, enPassantMove, status
-    std::vector<
-        std::tuple<std::shared_ptr<Square>, std::shared_ptr<Square>,
-                   std::shared_ptr<Piece>, std::shared_ptr<Piece>, bool, bool, gameStatus>>
-        moves;
+    std::vector<MoveRecord> moves;
+    // Start and end square of a pawn move waiting on a promotion choice
+    std::pair<int, int> pendingPromotion;
+    gameStatus statusBeforePromotion;
+    void updateStatus();
 
   public:
     Game();
-    Game(pieceColor pCurrentTurn, gameStatus pStatus, opponents pOpponent, std::shared_ptr<Board> pBoard);
     void resetGame();
     pieceColor getCurrentTurn();
     void setCurrentTurn(pieceColor newCurrentTurn);
@@ -30,7 +36,8 @@ class Game : public std::enable_shared_from_this<Game> {
     void setStatus(gameStatus newStatus);
     opponents getOpponent();
     void setOpponent(opponents newOpponent);
-    bool turn(std::shared_ptr<Square> start, std::shared_ptr<Square> end, bool dummyFlag = false);
+    bool turn(std::shared_ptr<Square> start, std::shared_ptr<Square> end);
+    void playMove(Move move);
     std::shared_ptr<Board> getBoard();
     void promote(pieceType chosenType);
     void undoMove();
@@ -0,0 +1,72 @@
+#ifndef Move_hpp
+#define Move_hpp
+
+#include "Types.hpp"
+#include <array>
+
+// Moves are packed into 16 bits: start square, end square and a 4 bit flag
+using Move = std::uint16_t;
+
+constexpr Move noMove = 0;
+
+enum class moveFlag {
+    quiet = 0,
+    doublePush = 1,
+    kingCastle = 2,
+    queenCastle = 3,
+    capture = 4,
+    enPassant = 5,
+    knightPromotion = 8,
+    bishopPromotion = 9,
+    rookPromotion = 10,
+    queenPromotion = 11,
+    knightPromotionCapture = 12,
+    bishopPromotionCapture = 13,
+    rookPromotionCapture = 14,
+    queenPromotionCapture = 15
+};
+
+constexpr Move encodeMove(int from, int to, moveFlag flag = moveFlag::quiet) {
+    return static_cast<Move>(from | (to << 6) | (static_cast<int>(flag) << 12));
+}
+
+constexpr int moveFrom(Move move) { return move & 63; }
+
+constexpr int moveTo(Move move) { return (move >> 6) & 63; }
+
+constexpr moveFlag flagOf(Move move) { return static_cast<moveFlag>(move >> 12); }
+
+constexpr bool isCapture(Move move) { return (move >> 12) & 4; }
+
+constexpr bool isPromotion(Move move) { return (move >> 12) & 8; }
+
+constexpr bool isCastling(Move move) {
+    return flagOf(move) == moveFlag::kingCastle || flagOf(move) == moveFlag::queenCastle;
+}
+
+constexpr pieceType promotionType(Move move) {
+    constexpr std::array<pieceType, 4> types = {
+        pieceType::Knight, pieceType::Bishop, pieceType::Rook, pieceType::Queen};
+    return isPromotion(move) ? types[(move >> 12) & 3] : pieceType::Base;
+}
+
+// Fixed capacity list, no legal position has more than 218 moves
+class MoveList {
+  private:
+    std::array<Move, 256> moves;
+    int count = 0;
+
+  public:
+    void push(Move move) { moves[count++] = move; }
+    void clear() { count = 0; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    Move &operator[](int index) { return moves[index]; }
+    Move operator[](int index) const { return moves[index]; }
+    Move *begin() { return moves.data(); }
+    Move *end() { return moves.data() + count; }
+    const Move *begin() const { return moves.data(); }
+    const Move *end() const { return moves.data() + count; }
+};
+
+#endif
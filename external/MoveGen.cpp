@@ -0,0 +1,247 @@
+#include "MoveGen.hpp"
+#include "Attacks.hpp"
+
+// Everything the generator needs to know about checks and pins, worked out
+// once per position from the king square outward
+struct LegalityMasks {
+    // Squares a non-king move must land on, all squares when not in check
+    Bitboard checkMask;
+    // Own pieces that can only move along the line to their king
+    Bitboard pinned;
+    int king;
+};
+
+static LegalityMasks computeMasks(const Position &position) {
+    pieceColor us = position.getSideToMove();
+    pieceColor them = opposite(us);
+    LegalityMasks masks;
+    masks.king = position.kingSquare(us);
+    masks.checkMask = ~Bitboard(0);
+    masks.pinned = 0;
+
+    Bitboard checkers = position.checkers();
+    if (checkers) {
+        // Single check can be answered by taking the checker or blocking it,
+        // double check only by moving the king
+        int checker = __builtin_ctzll(checkers);
+        masks.checkMask = (checkers & (checkers - 1)) ? 0 : between(masks.king, checker) | checkers;
+    }
+
+    // Enemy sliders that would see the king through exactly one own piece
+    Bitboard snipers =
+        (rookAttacks(masks.king, 0) & (position.pieces(them, pieceType::Rook) | position.pieces(them, pieceType::Queen))) |
+        (bishopAttacks(masks.king, 0) & (position.pieces(them, pieceType::Bishop) | position.pieces(them, pieceType::Queen)));
+    while (snipers) {
+        Bitboard blockers = between(masks.king, popLowest(snipers)) & position.pieces();
+        if (blockers && !(blockers & (blockers - 1))) {
+            masks.pinned |= blockers & position.pieces(us);
+        }
+    }
+
+    return masks;
+}
+
+// Emit one move per set bit of targets, all starting from the same square
+static void addMoves(const Position &position, MoveList &moves, int from, Bitboard targets) {
+    Bitboard enemies = position.pieces(opposite(position.getSideToMove()));
+    while (targets) {
+        int to = popLowest(targets);
+        moves.push(encodeMove(from, to, (enemies & squareBit(to)) ? moveFlag::capture : moveFlag::quiet));
+    }
+}
+
+static void addPromotions(MoveList &moves, int from, int to, bool capture) {
+    int base = capture ? static_cast<int>(moveFlag::knightPromotionCapture)
+                       : static_cast<int>(moveFlag::knightPromotion);
+    // Queen first, it's almost always the best choice
+    for (int offset = 3; offset >= 0; offset--) {
+        moves.push(encodeMove(from, to, static_cast<moveFlag>(base + offset)));
+    }
+}
+
+// Squares a piece on from may legally land on given checks and pins
+static Bitboard legalTargets(const LegalityMasks &masks, int from) {
+    return (masks.pinned & squareBit(from)) ? masks.checkMask & line(masks.king, from)
+                                            : masks.checkMask;
+}
+
+// En passant can uncover a check along the rank of both pawns, so it's
+// verified by looking at the king's lines with the final occupancy
+static bool isEnPassantLegal(const Position &position, int from, int to, int king) {
+    pieceColor them = opposite(position.getSideToMove());
+    int captured = squareIndex(rowOf(from), colOf(to));
+    Bitboard occupied = (position.pieces() ^ squareBit(from) ^ squareBit(captured)) | squareBit(to);
+    Bitboard attackers = position.attackersTo(king, occupied) & position.pieces(them) & ~squareBit(captured);
+    return !attackers;
+}
+
+// Unpinned pawns are generated all at once by shifting the pawn bitboard,
+// pinned pawns go through the same shifts one at a time with their pin line
+static void generatePawnMoves(const Position &position, MoveList &moves,
+                              const LegalityMasks &masks, Bitboard pawns, Bitboard allowed,
+                              generationMode mode) {
+    pieceColor us = position.getSideToMove();
+    bool isWhite = us == pieceColor::white;
+    Bitboard empty = ~position.pieces();
+    Bitboard enemies = position.pieces(opposite(us));
+    Bitboard lastRank = isWhite ? rank8 : rank1;
+    int forward = isWhite ? 8 : -8;
+
+    auto shift = [isWhite](Bitboard bitboard, int amount) {
+        return isWhite ? bitboard << amount : bitboard >> amount;
+    };
+
+    Bitboard singlePushes = shift(pawns, 8) & empty;
+    Bitboard doublePushes = shift(singlePushes & (isWhite ? rank3 : rank6), 8) & empty & allowed;
+    singlePushes &= allowed;
+    // Pushes only count as captures when they promote
+    if (mode == generationMode::captures) {
+        singlePushes &= lastRank;
+        doublePushes = 0;
+    }
+    // Captures towards the a-file and towards the h-file, as seen by white
+    Bitboard leftCaptures = shift(pawns & ~(isWhite ? fileA : fileH), 7) & enemies & allowed;
+    Bitboard rightCaptures = shift(pawns & ~(isWhite ? fileH : fileA), 9) & enemies & allowed;
+    int leftStep = isWhite ? 7 : -7;
+    int rightStep = isWhite ? 9 : -9;
+
+    Bitboard targets = singlePushes;
+    while (targets) {
+        int to = popLowest(targets);
+        if (squareBit(to) & lastRank) {
+            addPromotions(moves, to - forward, to, false);
+        } else {
+            moves.push(encodeMove(to - forward, to));
+        }
+    }
+
+    targets = doublePushes;
+    while (targets) {
+        int to = popLowest(targets);
+        moves.push(encodeMove(to - 2 * forward, to, moveFlag::doublePush));
+    }
+
+    for (auto [captures, step] : {std::pair{leftCaptures, leftStep}, std::pair{rightCaptures, rightStep}}) {
+        while (captures) {
+            int to = popLowest(captures);
+            if (squareBit(to) & lastRank) {
+                addPromotions(moves, to - step, to, true);
+            } else {
+                moves.push(encodeMove(to - step, to, moveFlag::capture));
+            }
+        }
+    }
+
+    // Pawns that could capture onto the en passant square are exactly those
+    // an enemy pawn on that square would attack
+    if (position.getEnPassant() != noSquare) {
+        int to = position.getEnPassant();
+        Bitboard attackers = pawnAttacks(opposite(us), to) & pawns;
+        while (attackers) {
+            int from = popLowest(attackers);
+            if (isEnPassantLegal(position, from, to, masks.king)) {
+                moves.push(encodeMove(from, to, moveFlag::enPassant));
+            }
+        }
+    }
+}
+
+static void generateCastling(const Position &position, MoveList &moves) {
+    pieceColor us = position.getSideToMove();
+    pieceColor them = opposite(us);
+    int homeRow = us == pieceColor::white ? 0 : 7;
+    int king = squareIndex(homeRow, 4);
+    std::uint8_t rights = position.getCastlingRights() &
+                          (us == pieceColor::white ? whiteKingside | whiteQueenside
+                                                   : blackKingside | blackQueenside);
+    if (!rights) {
+        return;
+    }
+
+    // King can't castle through or into check, squares up to the rook must be empty
+    Bitboard kingsidePath = squareBit(king + 1) | squareBit(king + 2);
+    Bitboard queensidePath = squareBit(king - 1) | squareBit(king - 2) | squareBit(king - 3);
+    if ((rights & (whiteKingside | blackKingside)) && !(position.pieces() & kingsidePath) &&
+        !position.isSquareAttacked(king + 1, them) && !position.isSquareAttacked(king + 2, them)) {
+        moves.push(encodeMove(king, king + 2, moveFlag::kingCastle));
+    }
+    if ((rights & (whiteQueenside | blackQueenside)) && !(position.pieces() & queensidePath) &&
+        !position.isSquareAttacked(king - 1, them) && !position.isSquareAttacked(king - 2, them)) {
+        moves.push(encodeMove(king, king - 2, moveFlag::queenCastle));
+    }
+}
+
+void generateMoves(const Position &position, MoveList &moves, generationMode mode) {
+    moves.clear();
+
+    pieceColor us = position.getSideToMove();
+    pieceColor them = opposite(us);
+    if (position.kingSquare(us) == noSquare) {
+        return;
+    }
+
+    LegalityMasks masks = computeMasks(position);
+    Bitboard occupied = position.pieces();
+    Bitboard own = position.pieces(us);
+    // Squares pieces other than pawns may move to
+    Bitboard targets = mode == generationMode::captures ? position.pieces(them) : ~own;
+
+    // King may go anywhere not attacked once it has stepped off its square,
+    // so sliders checking it along a line still cover the square behind it
+    Bitboard kingTargets = kingAttacks(masks.king) & targets;
+    Bitboard withoutKing = occupied ^ squareBit(masks.king);
+    while (kingTargets) {
+        int to = popLowest(kingTargets);
+        if (!(position.attackersTo(to, withoutKing) & position.pieces(them))) {
+            addMoves(position, moves, masks.king, squareBit(to));
+        }
+    }
+
+    // In double check only the king can move
+    if (!masks.checkMask) {
+        return;
+    }
+
+    Bitboard pawns = position.pieces(us, pieceType::Pawn);
+    generatePawnMoves(position, moves, masks, pawns & ~masks.pinned, masks.checkMask, mode);
+    Bitboard pinnedPawns = pawns & masks.pinned;
+    while (pinnedPawns) {
+        int from = popLowest(pinnedPawns);
+        generatePawnMoves(position, moves, masks, squareBit(from), legalTargets(masks, from), mode);
+    }
+
+    // A pinned knight can never move along its pin line
+    Bitboard knights = position.pieces(us, pieceType::Knight) & ~masks.pinned;
+    while (knights) {
+        int from = popLowest(knights);
+        addMoves(position, moves, from, knightAttacks(from) & targets & masks.checkMask);
+    }
+
+    Bitboard bishops = position.pieces(us, pieceType::Bishop) | position.pieces(us, pieceType::Queen);
+    while (bishops) {
+        int from = popLowest(bishops);
+        addMoves(position, moves, from, bishopAttacks(from, occupied) & targets & legalTargets(masks, from));
+    }
+
+    Bitboard rooks = position.pieces(us, pieceType::Rook) | position.pieces(us, pieceType::Queen);
+    while (rooks) {
+        int from = popLowest(rooks);
+        addMoves(position, moves, from, rookAttacks(from, occupied) & targets & legalTargets(masks, from));
+    }
+
+    if (mode == generationMode::all && masks.checkMask == ~Bitboard(0)) {
+        generateCastling(position, moves);
+    }
+}
+
+Move findLegalMove(const Position &position, int from, int to, pieceType promotion) {
+    MoveList moves;
+    generateMoves(position, moves);
+    for (auto move : moves) {
+        if (moveFrom(move) == from && moveTo(move) == to &&
+            (!isPromotion(move) || promotionType(move) == promotion)) {
+            return move;
+        }
+    }
+    return noMove;
+}
@@ -0,0 +1,22 @@
+#ifndef MoveGen_hpp
+#define MoveGen_hpp
+
+#include "Move.hpp"
+#include "Position.hpp"
+
+enum class generationMode {
+    all,
+    // Captures and promotions only, for quiescence search
+    captures
+};
+
+// Strictly legal moves for the side to move
+void generateMoves(const Position &position, MoveList &moves,
+                   generationMode mode = generationMode::all);
+
+// Legal move from start to end square, noMove if there isn't one
+// Promotions pick the piece given by promotion
+Move findLegalMove(const Position &position, int from, int to,
+                   pieceType promotion = pieceType::Queen);
+
+#endif
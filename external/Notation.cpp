@@ -0,0 +1,124 @@
+#include "Notation.hpp"
+#include "MoveGen.hpp"
+#include <cctype>
+
+// Letters indexed by pieceType, pawns have none in SAN
+static const std::string sanLetters = " PRNBKQ";
+
+std::string squareName(int square) {
+    return {static_cast<char>('a' + colOf(square)), static_cast<char>('1' + rowOf(square))};
+}
+
+std::string moveToUci(Move move) {
+    if (move == noMove) {
+        return "0000";
+    }
+    std::string text = squareName(moveFrom(move)) + squareName(moveTo(move));
+    if (isPromotion(move)) {
+        text += static_cast<char>(std::tolower(sanLetters[typeIndex(promotionType(move))]));
+    }
+    return text;
+}
+
+Move moveFromUci(const Position &position, const std::string &text) {
+    MoveList moves;
+    generateMoves(position, moves);
+    for (auto move : moves) {
+        if (moveToUci(move) == text) {
+            return move;
+        }
+    }
+    return noMove;
+}
+
+// SAN without the check or mate suffix
+static std::string sanWithoutCheck(const Position &position, const MoveList &legalMoves,
+                                   Move move) {
+    if (flagOf(move) == moveFlag::kingCastle) {
+        return "O-O";
+    }
+    if (flagOf(move) == moveFlag::queenCastle) {
+        return "O-O-O";
+    }
+
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    pieceType type = position.pieceOn(from);
+    std::string text;
+
+    if (type == pieceType::Pawn) {
+        if (isCapture(move)) {
+            text += static_cast<char>('a' + colOf(from));
+        }
+    } else {
+        text += sanLetters[typeIndex(type)];
+        // Name the start file, rank or both when another piece of the same
+        // type could also move to the end square
+        bool ambiguous = false;
+        bool sameFile = false;
+        bool sameRank = false;
+        for (auto other : legalMoves) {
+            int otherFrom = moveFrom(other);
+            if (other != move && moveTo(other) == to && otherFrom != from &&
+                position.pieceOn(otherFrom) == type) {
+                ambiguous = true;
+                sameFile |= colOf(otherFrom) == colOf(from);
+                sameRank |= rowOf(otherFrom) == rowOf(from);
+            }
+        }
+        if (ambiguous && (!sameFile || sameRank)) {
+            text += static_cast<char>('a' + colOf(from));
+        }
+        if (ambiguous && sameFile) {
+            text += static_cast<char>('1' + rowOf(from));
+        }
+    }
+
+    if (isCapture(move)) {
+        text += 'x';
+    }
+    text += squareName(to);
+    if (isPromotion(move)) {
+        text += '=';
+        text += sanLetters[typeIndex(promotionType(move))];
+    }
+    return text;
+}
+
+std::string moveToSan(const Position &position, Move move) {
+    MoveList legalMoves;
+    generateMoves(position, legalMoves);
+    std::string text = sanWithoutCheck(position, legalMoves, move);
+
+    Position after = position;
+    UndoInfo undo;
+    after.makeMove(move, undo);
+    if (after.checkers()) {
+        MoveList replies;
+        generateMoves(after, replies);
+        text += replies.empty() ? '#' : '+';
+    }
+    return text;
+}
+
+Move moveFromSan(const Position &position, const std::string &text) {
+    std::string stripped = text;
+    while (!stripped.empty() && std::string("+#!?").find(stripped.back()) != std::string::npos) {
+        stripped.pop_back();
+    }
+    // Castling is sometimes written with zeros
+    if (stripped == "0-0") {
+        stripped = "O-O";
+    } else if (stripped == "0-0-0") {
+        stripped = "O-O-O";
+    }
+
+    MoveList legalMoves;
+    generateMoves(position, legalMoves);
+    for (auto move : legalMoves) {
+        if (sanWithoutCheck(position, legalMoves, move) == stripped) {
+            return move;
+        }
+    }
+    return noMove;
+}
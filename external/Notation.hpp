@@ -0,0 +1,24 @@
+#ifndef Notation_hpp
+#define Notation_hpp
+
+#include "Move.hpp"
+#include "Position.hpp"
+#include <string>
+
+// Square name such as e4
+std::string squareName(int square);
+
+// Long algebraic notation as used by UCI, e.g. e2e4 or e7e8q
+std::string moveToUci(Move move);
+
+// Legal move in position written as UCI text, noMove if there isn't one
+Move moveFromUci(const Position &position, const std::string &text);
+
+// Standard algebraic notation, e.g. Nf3, exd5, O-O or e8=Q+
+std::string moveToSan(const Position &position, Move move);
+
+// Legal move in position written in SAN, check marks and annotations such
+// as + # ! ? are optional. noMove if there isn't one
+Move moveFromSan(const Position &position, const std::string &text);
+
+#endif
@@ -0,0 +1,202 @@
+#include "OpeningBook.hpp"
+#include "MoveGen.hpp"
+#include "Polyglot.hpp"
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+constexpr std::size_t bookEntrySize = 16;
+
+// Big-endian number count bytes long, as Polyglot stores them
+static std::uint64_t readBigEndian(const unsigned char *bytes, int count) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < count; i++) {
+        value = value << 8 | bytes[i];
+    }
+    return value;
+}
+
+static void writeBigEndian(std::ofstream &file, std::uint64_t value, int count) {
+    for (int i = count - 1; i >= 0; i--) {
+        file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+OpeningBook::OpeningBook() {
+    data = nullptr;
+    sizeInBytes = 0;
+    entryCount = 0;
+}
+
+OpeningBook::~OpeningBook() { this->close(); }
+
+// Any book already open is closed first, false if the file can't be read
+bool OpeningBook::open(const std::string &path) {
+    this->close();
+#if defined(_WIN32)
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (buffer.size() < bookEntrySize) {
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    sizeInBytes = buffer.size();
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || static_cast<std::size_t>(status.st_size) < bookEntrySize) {
+        ::close(descriptor);
+        return false;
+    }
+    void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // The mapping stays valid once the descriptor is closed
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<const unsigned char *>(mapping);
+    sizeInBytes = status.st_size;
+#endif
+    entryCount = sizeInBytes / bookEntrySize;
+    return true;
+}
+
+void OpeningBook::close() {
+    if (data == nullptr) {
+        return;
+    }
+#if defined(_WIN32)
+    buffer.clear();
+#else
+    munmap(const_cast<unsigned char *>(data), sizeInBytes);
+#endif
+    data = nullptr;
+    sizeInBytes = 0;
+    entryCount = 0;
+}
+
+BookEntry OpeningBook::entryAt(std::size_t index) const {
+    const unsigned char *bytes = data + index * bookEntrySize;
+    BookEntry entry;
+    entry.key = readBigEndian(bytes, 8);
+    entry.move = static_cast<std::uint16_t>(readBigEndian(bytes + 8, 2));
+    entry.weight = static_cast<std::uint16_t>(readBigEndian(bytes + 10, 2));
+    entry.learn = static_cast<std::uint32_t>(readBigEndian(bytes + 12, 4));
+    return entry;
+}
+
+// Entries are sorted by key, so the position's moves are found by binary
+// search for the first entry with its key and read up from there
+std::vector<std::pair<Move, int>> OpeningBook::probeAll(const Position &position) const {
+    std::vector<std::pair<Move, int>> moves;
+    if (data == nullptr) {
+        return moves;
+    }
+
+    Key key = polyglotKey(position);
+    std::size_t low = 0;
+    std::size_t high = entryCount;
+    while (low < high) {
+        std::size_t middle = low + (high - low) / 2;
+        if (this->entryAt(middle).key < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    for (std::size_t i = low; i < entryCount; i++) {
+        BookEntry entry = this->entryAt(i);
+        if (entry.key != key) {
+            break;
+        }
+        // Moves that aren't legal here mean a key collision
+        Move move = decodeBookMove(position, entry.move);
+        if (move != noMove) {
+            moves.emplace_back(move, entry.weight);
+        }
+    }
+    return moves;
+}
+
+Move OpeningBook::probe(const Position &position) const {
+    std::vector<std::pair<Move, int>> moves = this->probeAll(position);
+    int totalWeight = 0;
+    for (auto &[move, weight] : moves) {
+        totalWeight += weight;
+    }
+    if (totalWeight == 0) {
+        return noMove;
+    }
+
+    // Searches run on their own threads, each gets its own generator
+    thread_local std::mt19937 generator(std::random_device{}());
+    int pick = std::uniform_int_distribution<int>(0, totalWeight - 1)(generator);
+    for (auto &[move, weight] : moves) {
+        pick -= weight;
+        if (pick < 0) {
+            return move;
+        }
+    }
+    return noMove;
+}
+
+std::uint16_t encodeBookMove(Move move) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    if (flagOf(move) == moveFlag::kingCastle) {
+        to = from + 3;
+    } else if (flagOf(move) == moveFlag::queenCastle) {
+        to = from - 4;
+    }
+    // Knight 1, bishop 2, rook 3, queen 4, the same order as the move flags
+    int promotion = isPromotion(move) ? ((move >> 12) & 3) + 1 : 0;
+    return static_cast<std::uint16_t>(colOf(to) | rowOf(to) << 3 | colOf(from) << 6 |
+                                      rowOf(from) << 9 | promotion << 12);
+}
+
+Move decodeBookMove(const Position &position, std::uint16_t bookMove) {
+    MoveList moves;
+    generateMoves(position, moves);
+    for (auto move : moves) {
+        if (encodeBookMove(move) == bookMove) {
+            return move;
+        }
+    }
+    return noMove;
+}
+
+bool writeBook(const std::string &path, std::vector<BookEntry> entries) {
+    // Heaviest move first within each position, like Polyglot books
+    std::sort(entries.begin(), entries.end(), [](const BookEntry &a, const BookEntry &b) {
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    for (auto &entry : entries) {
+        writeBigEndian(file, entry.key, 8);
+        writeBigEndian(file, entry.move, 2);
+        writeBigEndian(file, entry.weight, 2);
+        writeBigEndian(file, entry.learn, 4);
+    }
+    return static_cast<bool>(file);
+}
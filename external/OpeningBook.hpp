@@ -0,0 +1,62 @@
+#ifndef OpeningBook_hpp
+#define OpeningBook_hpp
+
+#include "Move.hpp"
+#include "Position.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// One book record. On disk it takes 16 bytes, big-endian, as a Polyglot
+// book entry, sorted by key
+struct BookEntry {
+    Key key;
+    // Polyglot move: to file, to row, from file, from row and promotion
+    // piece in 3 bits each. Castling is written as the king taking its rook
+    std::uint16_t move;
+    std::uint16_t weight;
+    std::uint32_t learn;
+};
+
+// Read-only Polyglot book memory-mapped from a file and searched by
+// polyglotKey, so opening it costs nothing and a probe touches a handful of
+// pages
+class OpeningBook {
+  private:
+    const unsigned char *data;
+    std::size_t sizeInBytes;
+    std::size_t entryCount;
+#if defined(_WIN32)
+    // No mmap, the file is read into memory instead
+    std::vector<unsigned char> buffer;
+#endif
+
+    BookEntry entryAt(std::size_t index) const;
+
+  public:
+    OpeningBook();
+    ~OpeningBook();
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+    std::size_t size() const { return entryCount; }
+    // Legal book moves for the position with their weights
+    std::vector<std::pair<Move, int>> probeAll(const Position &position) const;
+    // Book move picked at random in proportion to its weight, noMove when
+    // the position isn't in the book
+    Move probe(const Position &position) const;
+};
+
+std::uint16_t encodeBookMove(Move move);
+
+// Legal move in position matching a book move, noMove if there isn't one
+Move decodeBookMove(const Position &position, std::uint16_t bookMove);
+
+// Sort entries into book order and write them, false if the file can't be
+// written
+bool writeBook(const std::string &path, std::vector<BookEntry> entries);
+
+#endif
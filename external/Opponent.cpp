@@ -1,295 +1,588 @@
 #include "Opponent.hpp"
+#include "Attacks.hpp"
+#include "Endgame.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
 
-std::vector<std::array<int, 4>> getAiMoves(std::shared_ptr<Game> game, pieceColor color) {
-    std::shared_ptr<Board> board = game->getBoard();
+// Shared by every search so results carry over between the AI's turns
+static TranspositionTable transpositionTable;
 
-    // Get all squares with pieces belonging to the computer
-    std::vector<std::shared_ptr<Square>> aiSquares;
-    for (int i = 7; i >= 0; i--) {
-        for (int j = 0; j < 8; j++) {
-            auto square = board->getSquare(i, j);
-            if (square->getPiece() != nullptr && square->getPiece()->getColor() == color) {
-                aiSquares.push_back(square);
-            }
+TranspositionTable &getTranspositionTable() { return transpositionTable; }
+
+// Empty until a book file is opened, then consulted before every search
+static OpeningBook openingBook;
+
+OpeningBook &getOpeningBook() { return openingBook; }
+
+// One writer per counter, so a relaxed load and store is enough and avoids
+// a locked increment on every node
+static void countNode(SearchContext &context) {
+    context.nodes.store(context.nodes.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+}
+
+// Nodes searched so far by the thread and, on the main thread, its helpers
+static std::uint64_t totalNodes(const SearchContext &context) {
+    std::uint64_t nodes = context.nodes.load(std::memory_order_relaxed);
+    if (context.helpers != nullptr) {
+        for (auto &helper : *context.helpers) {
+            nodes += helper->nodes.load(std::memory_order_relaxed);
         }
     }
+    return nodes;
+}
+
+// Time and node budgets are checked every 2048 nodes
+static void checkLimits(SearchContext &context) {
+    if (!context.canStop) {
+        return;
+    }
+    if (context.stopSignal != nullptr && context.stopSignal->load(std::memory_order_relaxed)) {
+        context.stopped = true;
+    }
+    std::uint64_t nodes = context.nodes.load(std::memory_order_relaxed);
+    if (context.limits.maxNodes != 0 && nodes >= context.limits.maxNodes) {
+        context.stopped = true;
+    }
+    if ((nodes & 2047) == 0 && context.limits.moveTime.count() != 0 &&
+        std::chrono::steady_clock::now() - context.start >= context.limits.moveTime) {
+        context.stopped = true;
+    }
+}
+
+// Piece values used only to order captures, indexed by pieceType
+constexpr std::array<int, 7> orderValue = {0, 1, 5, 3, 3, 10, 9};
 
-    // startRow, startCol, endRow, endCol
-    std::vector<std::array<int, 4>> aiMoves;
-    // Get all possible moves the computer can make
-    for (auto startSquare : aiSquares) {
-        if (startSquare->getPiece() != nullptr) {
-            for (auto endSquare : startSquare->getPiece()->legalMoves(board, startSquare)) {
-                aiMoves.push_back({startSquare->getRow(), startSquare->getCol(), endSquare.first, endSquare.second});
+constexpr int hashMoveScore = 1 << 30;
+constexpr int captureScore = 1 << 29;
+constexpr int killerScore = 1 << 28;
+
+// Score every move so the ones most likely to cause a cutoff come first:
+// hash move, captures by most valuable victim then least valuable attacker,
+// killers, and finally quiet moves by history
+static void scoreMoves(const Position &position, const MoveList &moves,
+                       std::array<int, 256> &scores, Move hashMove, int ply,
+                       const SearchContext &context) {
+    int side = colorIndex(position.getSideToMove());
+    for (int i = 0; i < moves.size(); i++) {
+        Move move = moves[i];
+        int from = moveFrom(move);
+        int to = moveTo(move);
+        if (move == hashMove) {
+            scores[i] = hashMoveScore;
+        } else if (isCapture(move) || isPromotion(move)) {
+            pieceType victim = flagOf(move) == moveFlag::enPassant ? pieceType::Pawn
+                               : isCapture(move)                  ? position.pieceOn(to)
+                                                                  : pieceType::Base;
+            scores[i] = captureScore + 16 * orderValue[typeIndex(victim)] -
+                        orderValue[typeIndex(position.pieceOn(from))] +
+                        16 * orderValue[typeIndex(promotionType(move))];
+        } else if (ply < maxPly && move == context.killers[ply][0]) {
+            scores[i] = killerScore + 1;
+        } else if (ply < maxPly && move == context.killers[ply][1]) {
+            scores[i] = killerScore;
+        } else {
+            scores[i] = context.history[side][from][to];
+        }
+    }
+}
+
+// Selection sort one step at a time, most nodes cut off after a few moves so
+// sorting the whole list up front would be wasted work
+static void pickNextMove(MoveList &moves, std::array<int, 256> &scores, int index) {
+    int best = index;
+    for (int i = index + 1; i < moves.size(); i++) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    std::swap(moves[index], moves[best]);
+    std::swap(scores[index], scores[best]);
+}
+
+// Remember a quiet move that caused a beta cutoff
+static void updateQuietCutoff(const Position &position, Move move, int depth, int ply,
+                              SearchContext &context) {
+    if (ply < maxPly && context.killers[ply][0] != move) {
+        context.killers[ply][1] = context.killers[ply][0];
+        context.killers[ply][0] = move;
+    }
+    int &score = context.history[colorIndex(position.getSideToMove())][moveFrom(move)]
+                                [moveTo(move)];
+    score += depth * depth;
+    // Keep history below the killer scores, halving every entry keeps
+    // their relative order
+    if (score >= killerScore / 2) {
+        for (auto &side : context.history) {
+            for (auto &from : side) {
+                for (auto &value : from) {
+                    value /= 2;
+                }
             }
         }
     }
+}
+
+// Score of the side to move being mated ply plies from the root
+static float matedScore(bool isMaximising, int ply) {
+    return isMaximising ? -(mateScore - ply) : mateScore - ply;
+}
+
+// Mate scores count plies from the root, the table stores them counted from
+// the node instead so they stay right wherever the position comes up again
+static float scoreToTable(float score, int ply) {
+    if (std::abs(score) >= mateThreshold) {
+        return score > 0 ? score + ply : score - ply;
+    }
+    return score;
+}
+
+static float scoreFromTable(float score, int ply) {
+    if (std::abs(score) >= mateThreshold) {
+        return score > 0 ? score - ply : score + ply;
+    }
+    return score;
+}
+
+// Search every root move to depth, previous best first, and return the best
+// move with its score. Result is meaningless if the search was stopped
+static std::pair<Move, float> searchRoot(Position &position, MoveList &rootMoves, int depth,
+                                         SearchContext &context) {
+    bool isMaximising = position.getSideToMove() == pieceColor::black;
+    float alpha = -mateScore;
+    float beta = mateScore;
+    Move bestMove = rootMoves[0];
+    float bestScore = isMaximising ? -mateScore : mateScore;
+
+    for (auto move : rootMoves) {
+        UndoInfo undo;
+        position.makeMove(move, undo);
+        float moveScore =
+            miniMax(depth - 1, 1, position, !isMaximising, alpha, beta, context);
+        position.unmakeMove(move, undo);
+        if (context.stopped) {
+            break;
+        }
+        // Select move with best evaluation at end of minimax, later moves
+        // have to be strictly better to replace the previous best
+        if (isMaximising ? moveScore > bestScore : moveScore < bestScore) {
+            bestMove = move;
+            bestScore = moveScore;
+        }
+        if (isMaximising) {
+            alpha = std::max(alpha, bestScore);
+        } else {
+            beta = std::min(beta, bestScore);
+        }
+    }
 
-    return aiMoves;
+    return {bestMove, bestScore};
 }
 
-// Root of minimax process
-void opponentTurn(std::shared_ptr<Game> game) {
-    std::shared_ptr<Board> board = game->getBoard();
-
-    auto aiMoves = getAiMoves(game, pieceColor::black);
-
-    std::array<int, 4> bestMove;
-    float bestScore = -99999999;
-    int depth = 3;
-    bool isMaximisingPlayer = true;
-    // Iterate through each possible move and start a recursive minimax
-    for (auto move : aiMoves) {
-        // Clone board and game to prevent any side effects bleeding over into actual game/board
-        auto dummyBoard = std::make_shared<Board>(Board(board->getSquares()));
-        auto dummyGame = std::make_shared<Game>(Game(game->getCurrentTurn(), game->getStatus(), game->getOpponent(), dummyBoard));
-        if (dummyGame->turn(dummyBoard->getSquare(move[0], move[1]), dummyBoard->getSquare(move[2], move[3]))) {
-            float moveScore = miniMax(depth - 1, dummyGame, !isMaximisingPlayer, -10000, 10000);
-            // Select move with highest evaluation at end of minimax
-            if (moveScore >= bestScore) {
-                bestMove = move;
-                bestScore = moveScore;
+// Iterative deepening: search depth 1, 2, 3... until the budget runs out and
+// keep the result of the deepest completed iteration
+static SearchResult iterativeDeepening(Position &position, MoveList rootMoves, int firstDepth,
+                                       SearchContext &context, SearchControl *control) {
+    SearchResult result;
+    for (int depth = firstDepth; depth <= context.limits.maxDepth && !rootMoves.empty();
+         depth++) {
+        // Depth 1 always completes so there is a move to play
+        context.canStop = depth > 1;
+        auto [bestMove, bestScore] = searchRoot(position, rootMoves, depth, context);
+        if (context.stopped) {
+            break;
+        }
+
+        result.bestMove = bestMove;
+        result.score = bestScore;
+        result.depth = depth;
+        result.nodes = totalNodes(context);
+        result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - context.start);
+        if (control != nullptr) {
+            result.principalVariation = principalVariation(position, bestMove, depth);
+            if (control->onIteration) {
+                control->onIteration(result);
             }
         }
+
+        // Best move from this depth is searched first at the next one
+        Move *best = std::find(rootMoves.begin(), rootMoves.end(), bestMove);
+        std::rotate(rootMoves.begin(), best, best + 1);
+
+        // No point searching deeper once a forced mate is found within the
+        // depth searched, mates further off may come from the table and
+        // still be shortened by a deeper search
+        if (std::abs(bestScore) >= mateThreshold && mateScore - std::abs(bestScore) <= depth) {
+            break;
+        }
+    }
+    return result;
+}
+
+// Lazy SMP: helper threads search the same position alongside the main
+// thread, sharing nothing but the transposition table. Their results are
+// thrown away, the main thread finds the table full of them and cuts off
+// sooner. Only the main thread watches the budget and stops the helpers
+SearchResult searchPosition(Position position, const SearchLimits &limits,
+                            SearchControl *control) {
+    auto start = std::chrono::steady_clock::now();
+    if (limits.useBook) {
+        Move bookMove = openingBook.probe(position);
+        if (bookMove != noMove) {
+            SearchResult result;
+            result.bestMove = bookMove;
+            result.principalVariation = {bookMove};
+            result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            return result;
+        }
+    }
+
+    MoveList rootMoves;
+    generateMoves(position, rootMoves);
+    transpositionTable.newSearch();
+
+    std::atomic<bool> stopSignal = false;
+    std::vector<std::unique_ptr<SearchContext>> helperContexts;
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < limits.threads; i++) {
+        auto helperContext = std::make_unique<SearchContext>();
+        helperContext->limits = limits;
+        helperContext->limits.moveTime = std::chrono::milliseconds(0);
+        helperContext->limits.maxNodes = 0;
+        helperContext->start = start;
+        helperContext->stopSignal = &stopSignal;
+        // Half the helpers start a depth ahead so they aren't all in step
+        helpers.emplace_back([position, rootMoves, i, context = helperContext.get()]() mutable {
+            iterativeDeepening(position, rootMoves, 1 + i % 2, *context, nullptr);
+        });
+        helperContexts.push_back(std::move(helperContext));
+    }
+
+    SearchContext context;
+    context.limits = limits;
+    context.start = start;
+    context.helpers = &helperContexts;
+    if (control != nullptr) {
+        context.stopSignal = &control->stop;
+    }
+    SearchResult result = iterativeDeepening(position, rootMoves, 1, context, control);
+
+    stopSignal = true;
+    for (auto &helper : helpers) {
+        helper.join();
+    }
+
+    result.nodes = totalNodes(context);
+    transpositionTable.addStatistics(context.ttProbes, context.ttHits);
+    for (auto &helperContext : helperContexts) {
+        transpositionTable.addStatistics(helperContext->ttProbes, helperContext->ttHits);
+    }
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+// Follow best moves stored in the transposition table from the position
+// after bestMove, stopping at a missing or illegal move or a repetition
+std::vector<Move> principalVariation(Position position, Move bestMove, int maxLength) {
+    std::vector<Move> line;
+    std::vector<Key> seen = {position.getKey()};
+    Move move = bestMove;
+    while (move != noMove && static_cast<int>(line.size()) < maxLength) {
+        MoveList legalMoves;
+        generateMoves(position, legalMoves);
+        if (std::find(legalMoves.begin(), legalMoves.end(), move) == legalMoves.end()) {
+            break;
+        }
+        UndoInfo undo;
+        position.makeMove(move, undo);
+        line.push_back(move);
+        if (std::find(seen.begin(), seen.end(), position.getKey()) != seen.end()) {
+            break;
+        }
+        seen.push_back(position.getKey());
+
+        TTEntry entry;
+        move = transpositionTable.probe(position.getKey(), entry) ? entry.move : noMove;
     }
+    return line;
+}
+
+// Search a copy of the game position and make the chosen move
+SearchResult opponentTurn(std::shared_ptr<Game> game, const SearchLimits &limits) {
+    SearchResult result = searchPosition(game->getBoard()->getPosition(), limits);
 
-    // Make chosen move
-    auto startSquare = board->getSquare(bestMove[0], bestMove[1]);
-    auto endSquare = board->getSquare(bestMove[2], bestMove[3]);
-    game->turn(startSquare, endSquare);
+    if (result.bestMove != noMove) {
+        game->playMove(result.bestMove);
+    }
+    return result;
 }
 
 // Recursive minimax
-float miniMax(int depth, std::shared_ptr<Game> game, bool isMaximising, float alpha, float beta) {
-    // Base case, return final board evaluation
+float miniMax(int depth, int ply, Position &position, bool isMaximising, float alpha,
+              float beta, SearchContext &context) {
+    // Base case, settle any captures before evaluating the board
     if (depth == 0) {
-        return -evaluateBoard(game, game->getBoard());
+        return quiescence(ply, position, isMaximising, alpha, beta, context);
     }
-    
-    auto board = game->getBoard();
 
-    auto aiMoves = getAiMoves(game, (isMaximising ? pieceColor::black : pieceColor::white));
+    countNode(context);
+    checkLimits(context);
+    if (context.stopped) {
+        return 0;
+    }
 
-    // Black is the maximising player
-    if (isMaximising) {
-        float bestScore = -99999999;
-        for (auto move : aiMoves) {
-            if (game->turn(board->getSquare(move[0], move[1]), board->getSquare(move[2], move[3]))) {
-                bestScore = std::max(bestScore, miniMax(depth - 1, game, !isMaximising, alpha, beta));
-                alpha = std::max(alpha, bestScore);
-                game->undoMove();
-                // Alpha-beta pruning
-                if (beta <= alpha) {
-                    return bestScore;
-                }
-            }
+    // Known drawn endgames are exact, there is nothing to search
+    float endgameScore;
+    if (probeEndgame(position, endgameScore) == endgameResult::draw) {
+        return 0;
+    }
+
+    // Reuse earlier results for this position, reached now by a different
+    // move order or found on a previous turn
+    Move hashMove = noMove;
+    TTEntry entry;
+    context.ttProbes++;
+    if (transpositionTable.probe(position.getKey(), entry)) {
+        context.ttHits++;
+        hashMove = entry.move;
+        float tableScore = scoreFromTable(entry.score, ply);
+        if (entry.depth >= depth &&
+            (entry.getBound() == boundType::exact ||
+             (entry.getBound() == boundType::lower && tableScore >= beta) ||
+             (entry.getBound() == boundType::upper && tableScore <= alpha))) {
+            return tableScore;
+        }
+    }
+
+    MoveList aiMoves;
+    generateMoves(position, aiMoves);
+
+    // No legal moves is mate when in check and a draw otherwise
+    if (aiMoves.empty()) {
+        if (!position.checkers()) {
+            return 0;
         }
-        return bestScore;
+        return matedScore(isMaximising, ply);
+    }
+
+    std::array<int, 256> scores;
+    if (context.limits.orderMoves) {
+        scoreMoves(position, aiMoves, scores, hashMove, ply, context);
     } else {
-        float bestScore = 99999999;
-        for (auto move : aiMoves) {
-            if (game->turn(board->getSquare(move[0], move[1]), board->getSquare(move[2], move[3]))) {
-                bestScore = std::min(bestScore, miniMax(depth - 1, game, !isMaximising, alpha, beta));
-                beta = std::min(beta, bestScore);
-                game->undoMove();
-                if (beta <= alpha) {
-                    return bestScore;
-                }
+        // Best move found at this position before is searched first
+        for (int i = 0; i < aiMoves.size(); i++) {
+            if (aiMoves[i] == hashMove) {
+                std::swap(aiMoves[0], aiMoves[i]);
+                break;
             }
         }
-        return bestScore;
     }
-}
 
-// Each outcome is rated according to the value of the pieces left on the board
-float evaluateBoard(std::shared_ptr<Game> game, std::shared_ptr<Board> board) {
-    float score = 0;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            auto piece = board->getSquare(i, j)->getPiece();
-            if (piece != nullptr) {
-                score += ratePiece(piece->getColor(), piece->getPieceName(), i, j);
+    float alphaOrig = alpha;
+    float betaOrig = beta;
+    Move bestMove = noMove;
+    float bestScore = isMaximising ? -mateScore : mateScore;
+
+    // Black is the maximising player
+    for (int i = 0; i < aiMoves.size(); i++) {
+        if (context.limits.orderMoves) {
+            pickNextMove(aiMoves, scores, i);
+        }
+        Move move = aiMoves[i];
+        UndoInfo undo;
+        position.makeMove(move, undo);
+        float score = miniMax(depth - 1, ply + 1, position, !isMaximising, alpha, beta, context);
+        position.unmakeMove(move, undo);
+        // Abandoned subtrees return junk, which mustn't reach the table
+        if (context.stopped) {
+            return 0;
+        }
+
+        if (isMaximising ? score > bestScore : score < bestScore) {
+            bestScore = score;
+            bestMove = move;
+        }
+        if (isMaximising) {
+            alpha = std::max(alpha, bestScore);
+        } else {
+            beta = std::min(beta, bestScore);
+        }
+        // Alpha-beta pruning
+        if (beta <= alpha) {
+            if (!isCapture(move) && !isPromotion(move)) {
+                updateQuietCutoff(position, move, depth, ply, context);
             }
+            break;
         }
     }
 
-    return score;
+    // Scores are from black's point of view at every node, so the bound only
+    // depends on where the result fell relative to the original window
+    boundType bound = bestScore <= alphaOrig  ? boundType::upper
+                      : bestScore >= betaOrig ? boundType::lower
+                                              : boundType::exact;
+    transpositionTable.store(position.getKey(), depth, scoreToTable(bestScore, ply), bound,
+                             bestMove);
+
+    return bestScore;
 }
 
-// Define piece square tables used in piece evaluation
-std::array<std::array<float, 8>, 8> blackPawnTable = {{
-    {0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0},
-    {5.0,  5.0,  5.0,  5.0,  5.0,  5.0,  5.0,  5.0},
-    {1.0,  1.0,  2.0,  3.0,  3.0,  2.0,  1.0,  1.0},
-    {0.5,  0.5,  1.0,  2.5,  2.5,  1.0,  0.5,  0.5},
-    {0.0,  0.0,  0.0,  2.0,  2.0,  0.0,  0.0,  0.0},
-    {0.5, -0.5, -1.0,  0.0,  0.0, -1.0, -0.5,  0.5},
-    {0.5,  1.0,  1.0, -2.0, -2.0,  1.0,  1.0,  0.5},
-    {0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0},
-}};
-
-std::array<std::array<float, 8>, 8> whitePawnTable = {{
-    {0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0},
-    {0.5,  1.0,  1.0, -2.0, -2.0,  1.0,  1.0,  0.5},
-    {0.5, -0.5, -1.0,  0.0,  0.0, -1.0, -0.5,  0.5},
-    {0.0,  0.0,  0.0,  2.0,  2.0,  0.0,  0.0,  0.0},
-    {0.5,  0.5,  1.0,  2.5,  2.5,  1.0,  0.5,  0.5},
-    {1.0,  1.0,  2.0,  3.0,  3.0,  2.0,  1.0,  1.0},
-    {5.0,  5.0,  5.0,  5.0,  5.0,  5.0,  5.0,  5.0},
-    {0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0},
-}};
-
-std::array<std::array<float, 8>, 8> blackKnightTable = {{
-    {-5.0, -4.0, -3.0, -3.0, -3.0, -3.0, -4.0, -5.0},
-    {-4.0, -2.0,  0.0,  0.0,  0.0,  0.0, -2.0, -4.0},
-    {-3.0,  0.0,  1.0,  1.5,  1.5,  1.0,  0.0, -3.0},
-    {-3.0,  0.5,  1.5,  2.0,  2.0,  1.5,  0.5, -3.0},
-    {-3.0,  0.0,  1.5,  2.0,  2.0,  1.5,  0.0, -3.0},
-    {-3.0,  0.5,  1.0,  1.5,  1.5,  1.0,  0.5, -3.0},
-    {-4.0, -2.0,  0.0,  0.5,  0.5,  0.0, -2.0, -4.0},
-    {-5.0, -4.0, -3.0, -3.0, -3.0, -3.0, -4.0, -5.0},
-}};
-
-std::array<std::array<float, 8>, 8> whiteKnightTable = {{
-    {-5.0, -4.0, -3.0, -3.0, -3.0, -3.0, -4.0, -5.0},
-    {-4.0, -2.0,  0.0,  0.0,  0.0,  0.0, -2.0, -4.0},
-    {-3.0,  0.0,  1.0,  1.5,  1.5,  1.0,  0.0, -3.0},
-    {-3.0,  0.5,  1.5,  2.0,  2.0,  1.5,  0.5, -3.0},
-    {-3.0,  0.0,  1.5,  2.0,  2.0,  1.5,  0.0, -3.0},
-    {-3.0,  0.5,  1.0,  1.5,  1.5,  1.0,  0.5, -3.0},
-    {-4.0, -2.0,  0.0,  0.5,  0.5,  0.0, -2.0, -4.0},
-    {-5.0, -4.0, -3.0, -3.0, -3.0, -3.0, -4.0, -5.0},
-}};
-
-std::array<std::array<float, 8>, 8> blackBishopTable = {{
-    {-2.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -2.0},
-    {-1.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -1.0},
-    {-1.0,  0.0,  0.5,  1.0,  1.0,  0.5,  0.0, -1.0},
-    {-1.0,  0.5,  0.5,  1.0,  1.0,  0.5,  0.5, -1.0},
-    {-1.0,  0.0,  1.0,  1.0,  1.0,  1.0,  0.0, -1.0},
-    {-1.0,  1.0,  1.0,  1.0,  1.0,  1.0,  1.0, -1.0},
-    {-1.0,  0.5,  0.0,  0.0,  0.0,  0.0,  0.5, -1.0},
-    {-2.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -2.0},
-}};
-
-std::array<std::array<float, 8>, 8> whiteBishopTable = {{
-    {-2.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -2.0},
-    {-1.0,  0.5,  0.0,  0.0,  0.0,  0.0,  0.5, -1.0},
-    {-1.0,  1.0,  1.0,  1.0,  1.0,  1.0,  1.0, -1.0},
-    {-1.0,  0.0,  1.0,  1.0,  1.0,  1.0,  0.0, -1.0},
-    {-1.0,  0.5,  0.5,  1.0,  1.0,  0.5,  0.5, -1.0},
-    {-1.0,  0.0,  0.5,  1.0,  1.0,  0.5,  0.0, -1.0},
-    {-1.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -1.0},
-    {-2.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -2.0},
-}};
-
-std::array<std::array<float, 8>, 8> blackRookTable = {{
-    { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,  0.0},
-    { 0.5, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0,  0.5},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    { 0.0, 0.0, 0.0, 0.5, 0.5, 0.0, 0.0,  0.0},
-}};
-
-std::array<std::array<float, 8>, 8> whiteRookTable = {{
-    { 0.0, 0.0, 0.0, 0.5, 0.5, 0.0, 0.0,  0.0},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    {-0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.5},
-    { 0.5, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0,  0.5},
-    { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,  0.0},
-}};
-
-std::array<std::array<float, 8>, 8> blackQueenTable = {{
-    {-2.0, -1.0, -1.0, -0.5, -0.5, -1.0, -1.0, -2.0},
-    {-1.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -1.0},
-    {-1.0,  0.0,  0.5,  0.5,  0.5,  0.5,  0.0, -1.0},
-    {-0.5,  0.0,  0.5,  0.5,  0.5,  0.5,  0.0, -0.5},
-    { 0.0,  0.0,  0.5,  0.5,  0.5,  0.5,  0.0, -0.5},
-    {-1.0,  0.5,  0.5,  0.5,  0.5,  0.5,  0.0, -1.0},
-    {-1.0,  0.0,  0.5,  0.0,  0.0,  0.0,  0.0, -1.0},
-    {-2.0, -1.0, -1.0, -0.5, -0.5, -1.0, -1.0, -2.0},
-}};
-
-std::array<std::array<float, 8>, 8> whiteQueenTable = {{
-    {-2.0, -1.0, -1.0, -0.5, -0.5, -1.0, -1.0, -2.0},
-    {-1.0,  0.0,  0.5,  0.0,  0.0,  0.0,  0.0, -1.0},
-    {-1.0,  0.5,  0.5,  0.5,  0.5,  0.5,  0.0, -1.0},
-    { 0.0,  0.0,  0.5,  0.5,  0.5,  0.5,  0.0, -0.5},
-    {-0.5,  0.0,  0.5,  0.5,  0.5,  0.5,  0.0, -0.5},
-    {-1.0,  0.0,  0.5,  0.5,  0.5,  0.5,  0.0, -1.0},
-    {-1.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0, -1.0},
-    {-2.0, -1.0, -1.0, -0.5, -0.5, -1.0, -1.0, -2.0},
-}};
-
-std::array<std::array<float, 8>, 8> blackKingTable = {{
-    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
-    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
-    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
-    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
-    {-2.0, -3.0, -3.0, -4.0, -4.0, -3.0, -3.0, -2.0},
-    {-1.0, -2.0, -2.0, -2.0, -2.0, -2.0, -2.0, -1.0},
-    { 2.0,  2.0,  0.0,  0.0,  0.0,  0.0,  2.0,  2.0},
-    { 2.0,  3.0,  1.0,  0.0,  0.0,  1.0,  3.0,  2.0},
-}};
-
-std::array<std::array<float, 8>, 8> whiteKingTable = {{
-    { 2.0,  3.0,  1.0,  0.0,  0.0,  1.0,  3.0,  2.0},
-    { 2.0,  2.0,  0.0,  0.0,  0.0,  0.0,  2.0,  2.0},
-    {-1.0, -2.0, -2.0, -2.0, -2.0, -2.0, -2.0, -1.0},
-    {-2.0, -3.0, -3.0, -4.0, -4.0, -3.0, -3.0, -2.0},
-    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
-    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
-    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
-    {-3.0, -4.0, -4.0, -5.0, -5.0, -4.0, -4.0, -3.0},
-}};
-
-float ratePiece(pieceColor color, pieceType type, int row, int col) {
-    float score = 0;
-
-    switch (type) {
-        case pieceType::Pawn:
-            score = 10;
-            if (color == pieceColor::black) score += blackPawnTable[row][col];
-            else score += whitePawnTable[row][col];
-            break;
-        case pieceType::Knight:
-            score = 30;
-            if (color == pieceColor::black) score += blackKnightTable[row][col];
-            else score += whiteKnightTable[row][col];
-            break;
-        case pieceType::Bishop:
-            score = 30;
-            if (color == pieceColor::black) score += blackBishopTable[row][col];
-            else score += whiteBishopTable[row][col];
-            break;
-        case pieceType::Rook:
-            score = 50;
-            if (color == pieceColor::black) score += blackRookTable[row][col];
-            else score += whiteRookTable[row][col];
+// Material values used by static exchange evaluation, indexed by pieceType
+// and matching pieceValue, except that a king is worth more than everything
+constexpr std::array<int, 7> exchangeValue = {0, 10, 50, 30, 30, 1000, 90};
+
+// Net material won by a capture once every piece attacking the target
+// square has joined in, least valuable first, with either side free to
+// stop capturing when continuing would lose material
+int staticExchange(const Position &position, Move move) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    Bitboard occupied = position.pieces() ^ squareBit(from);
+    pieceType captured = position.pieceOn(to);
+    if (flagOf(move) == moveFlag::enPassant) {
+        occupied ^= squareBit(squareIndex(rowOf(from), colOf(to)));
+        captured = pieceType::Pawn;
+    }
+
+    Bitboard diagonal = position.pieces(pieceType::Bishop) | position.pieces(pieceType::Queen);
+    Bitboard straight = position.pieces(pieceType::Rook) | position.pieces(pieceType::Queen);
+    Bitboard attackers = position.attackersTo(to, occupied) & occupied;
+
+    // gain[i] is the score for the side making capture i if it's recaptured
+    std::array<int, 32> gain;
+    int depth = 0;
+    gain[0] = exchangeValue[typeIndex(captured)];
+    pieceType onTarget = position.pieceOn(from);
+    pieceColor side = opposite(position.getSideToMove());
+
+    while (true) {
+        depth++;
+        gain[depth] = exchangeValue[typeIndex(onTarget)] - gain[depth - 1];
+        // Neither side would continue from here
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) {
             break;
-        case pieceType::Queen:
-            score = 90;
-            if (color == pieceColor::black) score += blackQueenTable[row][col];
-            else score += whiteQueenTable[row][col];
+        }
+
+        Bitboard ours = attackers & position.pieces(side);
+        if (!ours) {
             break;
-        case pieceType::King:
-            if (color == pieceColor::black) score += blackKingTable[row][col];
-            else score += whiteKingTable[row][col];
-            score = 900;
+        }
+        for (auto type : {pieceType::Pawn, pieceType::Knight, pieceType::Bishop,
+                          pieceType::Rook, pieceType::Queen, pieceType::King}) {
+            Bitboard candidates = ours & position.pieces(type);
+            if (candidates) {
+                occupied ^= candidates & -candidates;
+                onTarget = type;
+                break;
+            }
+        }
+
+        // Sliders behind the piece that just captured now see the square
+        attackers |= (bishopAttacks(to, occupied) & diagonal) |
+                     (rookAttacks(to, occupied) & straight);
+        attackers &= occupied;
+        side = opposite(side);
+    }
+
+    while (--depth) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    }
+    return gain[0];
+}
+
+// Search only captures and promotions past the nominal depth, so positions
+// are never evaluated in the middle of an exchange. The side to move may
+// stand pat on the static evaluation instead of capturing, and captures
+// that lose material by static exchange aren't searched. In check every
+// evasion is searched and there is no standing pat
+float quiescence(int ply, Position &position, bool isMaximising, float alpha, float beta,
+                 SearchContext &context) {
+    countNode(context);
+    checkLimits(context);
+    if (context.stopped) {
+        return 0;
+    }
+
+    bool inCheck = position.checkers() != 0;
+    float bestScore = isMaximising ? -mateScore : mateScore;
+    if (!inCheck) {
+        bestScore = -evaluateBoard(position);
+        if (ply >= maxPly) {
+            return bestScore;
+        }
+        if (isMaximising) {
+            if (bestScore >= beta) {
+                return bestScore;
+            }
+            alpha = std::max(alpha, bestScore);
+        } else {
+            if (bestScore <= alpha) {
+                return bestScore;
+            }
+            beta = std::min(beta, bestScore);
+        }
+    }
+
+    MoveList moves;
+    generateMoves(position, moves, inCheck ? generationMode::all : generationMode::captures);
+    // Mated, a quiet position without captures keeps its stand pat score
+    if (moves.empty()) {
+        return inCheck ? matedScore(isMaximising, ply) : bestScore;
+    }
+
+    std::array<int, 256> scores;
+    scoreMoves(position, moves, scores, noMove, ply, context);
+
+    for (int i = 0; i < moves.size(); i++) {
+        pickNextMove(moves, scores, i);
+        Move move = moves[i];
+        if (!inCheck) {
+            // Underpromotions and losing captures can't beat standing pat
+            if (isPromotion(move) && promotionType(move) != pieceType::Queen) {
+                continue;
+            }
+            if (isCapture(move) && !isPromotion(move) && staticExchange(position, move) < 0) {
+                continue;
+            }
+        }
+
+        UndoInfo undo;
+        position.makeMove(move, undo);
+        float score = quiescence(ply + 1, position, !isMaximising, alpha, beta, context);
+        position.unmakeMove(move, undo);
+        if (context.stopped) {
+            return 0;
+        }
+
+        if (isMaximising ? score > bestScore : score < bestScore) {
+            bestScore = score;
+        }
+        if (isMaximising) {
+            alpha = std::max(alpha, bestScore);
+        } else {
+            beta = std::min(beta, bestScore);
+        }
+        if (beta <= alpha) {
             break;
-        default:
-            score = 0;
+        }
     }
 
-    if (color == pieceColor::black) {
-        return -score;
-    } else {
+    return bestScore;
+}
+
+// Each outcome is rated according to the value of the pieces left on the
+// board and the squares they stand on, kept up to date by the position.
+// Endgames the endgame module knows are rated by it instead
+float evaluateBoard(const Position &position) {
+    float score;
+    if (probeEndgame(position, score) != endgameResult::unknown) {
         return score;
     }
+    return position.evaluate();
 }
@@ -1,19 +1,109 @@
 #ifndef Opponent_hpp
 #define Opponent_hpp
 
-#include "Piece.hpp"
-#include "Square.hpp"
-#include "Board.hpp"
+#include "Position.hpp"
 #include "Game.hpp"
+#include "MoveGen.hpp"
+#include "OpeningBook.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
 
-std::vector<std::array<int, 4>> getAiMoves(std::shared_ptr<Game> game, pieceColor color);
+// Score of a position where black has been mated, from black's point of view.
+// Small enough that a float still tells one ply from the next
+constexpr float mateScore = 1000000;
 
-void opponentTurn(std::shared_ptr<Game> game);
+// Deepest ply the search keeps killer moves for
+constexpr int maxPly = 128;
 
-float miniMax(int depth, std::shared_ptr<Game> game, bool isMaximising, float alpha, float beta);
+// Mates are scored mateScore less the ply they happen at, so the search
+// prefers the quickest one. Any score beyond this is a mate
+constexpr float mateThreshold = mateScore - maxPly;
 
-float evaluateBoard(std::shared_ptr<Game> game, std::shared_ptr<Board> board);
+// Budget for one search, zero means no limit
+// Depth always completes at least 1 so there is a move to play
+struct SearchLimits {
+    int maxDepth = 64;
+    std::chrono::milliseconds moveTime{1000};
+    std::uint64_t maxNodes = 0;
+    // Off searches moves in generation order, with only the hash move
+    // first, so node counts can be compared against the ordered search
+    bool orderMoves = true;
+    // Search threads, one searches deterministically
+    int threads = 1;
+    // Play a move from the opening book without searching when there is one
+    bool useBook = true;
+    // Hold the result back until stopped, even once maxDepth or a mate is
+    // reached, as UCI wants for go infinite. Only Engine looks at it
+    bool infinite = false;
+};
 
-float ratePiece(pieceColor color, pieceType type, int row, int col);
+struct SearchResult {
+    Move bestMove = noMove;
+    // From black's point of view, like every minimax score
+    float score = 0;
+    // Deepest fully completed iteration
+    int depth = 0;
+    // Summed over every search thread
+    std::uint64_t nodes = 0;
+    std::chrono::milliseconds elapsed{0};
+    // Expected line of play starting with bestMove, read back from the
+    // transposition table
+    std::vector<Move> principalVariation;
+};
+
+// Lets another thread follow and stop a running search
+struct SearchControl {
+    // Ends the search once the first iteration is done
+    std::atomic<bool> stop = false;
+    // Called on the search thread after every completed iteration
+    std::function<void(const SearchResult &)> onIteration;
+};
+
+// State shared by every node of one search thread
+struct SearchContext {
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start;
+    // Only this thread counts, the main thread reads every helper's count
+    // while they run to report the nodes searched so far
+    std::atomic<std::uint64_t> nodes = 0;
+    std::uint64_t ttProbes = 0;
+    std::uint64_t ttHits = 0;
+    bool canStop = false;
+    bool stopped = false;
+    // Raised to stop this thread, by the main thread for helper threads and
+    // through SearchControl for the main thread
+    std::atomic<bool> *stopSignal = nullptr;
+    // Helper threads' contexts, set on the main thread only
+    const std::vector<std::unique_ptr<SearchContext>> *helpers = nullptr;
+    // Two quiet moves per ply that last caused a beta cutoff
+    std::array<std::array<Move, 2>, maxPly> killers = {};
+    // Cutoffs caused by each quiet move, indexed by colour, start and end square
+    std::array<std::array<std::array<int, 64>, 64>, 2> history = {};
+};
+
+TranspositionTable &getTranspositionTable();
+
+OpeningBook &getOpeningBook();
+
+SearchResult searchPosition(Position position, const SearchLimits &limits,
+                            SearchControl *control = nullptr);
+
+std::vector<Move> principalVariation(Position position, Move bestMove, int maxLength);
+
+SearchResult opponentTurn(std::shared_ptr<Game> game, const SearchLimits &limits = SearchLimits());
+
+float miniMax(int depth, int ply, Position &position, bool isMaximising, float alpha,
+              float beta, SearchContext &context);
+
+float quiescence(int ply, Position &position, bool isMaximising, float alpha, float beta,
+                 SearchContext &context);
+
+int staticExchange(const Position &position, Move move);
+
+float evaluateBoard(const Position &position);
 
 #endif
@@ -0,0 +1,11 @@
+#ifndef Polyglot_hpp
+#define Polyglot_hpp
+
+#include "Position.hpp"
+
+// Position hash as Polyglot opening books key their entries, so books made
+// by other tools can be read. Computed from scratch on every call, it is
+// only needed once per book probe and the search keeps its own Zobrist key
+Key polyglotKey(const Position &position);
+
+#endif
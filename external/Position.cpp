@@ -0,0 +1,429 @@
+#include "Position.hpp"
+#include "Attacks.hpp"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+// FEN letters indexed by pieceType, white pieces are upper case
+static const std::string pieceLetters = ".prnbkq";
+
+// Rights lost when a piece moves from or to a given square
+static std::uint8_t castlingRightsLost(int square) {
+    switch (square) {
+        case squareIndex(0, 0): return whiteQueenside;
+        case squareIndex(0, 7): return whiteKingside;
+        case squareIndex(0, 4): return whiteKingside | whiteQueenside;
+        case squareIndex(7, 0): return blackQueenside;
+        case squareIndex(7, 7): return blackKingside;
+        case squareIndex(7, 4): return blackKingside | blackQueenside;
+        default: return 0;
+    }
+}
+
+Position::Position() { this->clear(); }
+
+void Position::clear() {
+    byType.fill(0);
+    byColor.fill(0);
+    sideToMove = pieceColor::white;
+    castlingRights = 0;
+    enPassant = noSquare;
+    halfmoveClock = 0;
+    fullmoveNumber = 1;
+    key = 0;
+    score = TaperedScore();
+    phase = 0;
+}
+
+void Position::resetPosition() {
+    this->clear();
+
+    // Standard starting configuration
+    const std::array<pieceType, 8> backRank = {
+        pieceType::Rook, pieceType::Knight, pieceType::Bishop, pieceType::Queen,
+        pieceType::King, pieceType::Bishop, pieceType::Knight, pieceType::Rook};
+    for (int i = 0; i < 8; i++) {
+        putPiece(pieceColor::white, backRank[i], squareIndex(0, i));
+        putPiece(pieceColor::white, pieceType::Pawn, squareIndex(1, i));
+        putPiece(pieceColor::black, pieceType::Pawn, squareIndex(6, i));
+        putPiece(pieceColor::black, backRank[i], squareIndex(7, i));
+    }
+
+    setCastlingRights(whiteKingside | whiteQueenside | blackKingside | blackQueenside);
+}
+
+// Load a position from Forsyth-Edwards Notation. The move counters may be
+// left off. Returns false and leaves the position untouched if the FEN is
+// malformed or describes an impossible position
+bool Position::setFen(const std::string &fen) {
+    std::istringstream fields(fen);
+    std::string placement, side, castling, enPassantSquare;
+    int halfmoves = 0;
+    int fullmoves = 1;
+    if (!(fields >> placement >> side >> castling >> enPassantSquare)) {
+        return false;
+    }
+    if (!(fields >> halfmoves)) {
+        halfmoves = 0;
+    } else if (!(fields >> fullmoves)) {
+        fullmoves = 1;
+    }
+
+    Position result;
+
+    // Ranks are listed from black's back rank down
+    int row = 7;
+    int col = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            if (col != 8 || row == 0) {
+                return false;
+            }
+            row--;
+            col = 0;
+        } else if (c >= '1' && c <= '8') {
+            col += c - '0';
+            if (col > 8) {
+                return false;
+            }
+        } else {
+            unsigned char letter = static_cast<unsigned char>(c);
+            std::size_t type = pieceLetters.find(static_cast<char>(std::tolower(letter)));
+            if (type == std::string::npos || type == 0 || col >= 8) {
+                return false;
+            }
+            pieceColor color = std::isupper(letter) ? pieceColor::white : pieceColor::black;
+            result.putPiece(color, static_cast<pieceType>(type), squareIndex(row, col));
+            col++;
+        }
+    }
+    if (row != 0 || col != 8) {
+        return false;
+    }
+    if (__builtin_popcountll(result.pieces(pieceColor::white, pieceType::King)) != 1 ||
+        __builtin_popcountll(result.pieces(pieceColor::black, pieceType::King)) != 1) {
+        return false;
+    }
+
+    if (side != "w" && side != "b") {
+        return false;
+    }
+    result.setSideToMove(side == "w" ? pieceColor::white : pieceColor::black);
+    // The side that just moved can't have left its king in check
+    if (result.inCheck(opposite(result.sideToMove))) {
+        return false;
+    }
+
+    std::uint8_t rights = 0;
+    if (castling != "-") {
+        for (char c : castling) {
+            switch (c) {
+                case 'K': rights |= whiteKingside; break;
+                case 'Q': rights |= whiteQueenside; break;
+                case 'k': rights |= blackKingside; break;
+                case 'q': rights |= blackQueenside; break;
+                default: return false;
+            }
+        }
+    }
+    // Drop rights whose king or rook isn't on its starting square, so the
+    // move generator can trust them
+    for (int square : {squareIndex(0, 0), squareIndex(0, 4), squareIndex(0, 7),
+                       squareIndex(7, 0), squareIndex(7, 4), squareIndex(7, 7)}) {
+        pieceColor color = rowOf(square) == 0 ? pieceColor::white : pieceColor::black;
+        pieceType type = colOf(square) == 4 ? pieceType::King : pieceType::Rook;
+        if (!(result.pieces(color, type) & squareBit(square))) {
+            rights &= ~castlingRightsLost(square);
+        }
+    }
+    result.setCastlingRights(rights);
+
+    if (enPassantSquare != "-") {
+        int epRow = result.sideToMove == pieceColor::white ? 5 : 2;
+        if (enPassantSquare.size() != 2 || enPassantSquare[0] < 'a' || enPassantSquare[0] > 'h' ||
+            enPassantSquare[1] - '1' != epRow) {
+            return false;
+        }
+        // Kept only when a pawn can have just made the double push past it,
+        // so the move generator never captures a pawn that isn't there
+        int square = squareIndex(epRow, enPassantSquare[0] - 'a');
+        int push = result.sideToMove == pieceColor::white ? 8 : -8;
+        if ((result.pieces(opposite(result.sideToMove), pieceType::Pawn) &
+             squareBit(square - push)) &&
+            result.isEmpty(square) && result.isEmpty(square + push)) {
+            result.setEnPassant(square);
+        }
+    }
+
+    if (halfmoves < 0 || halfmoves > 255 || fullmoves < 1 || fullmoves > 65535) {
+        return false;
+    }
+    result.halfmoveClock = static_cast<std::uint8_t>(halfmoves);
+    result.fullmoveNumber = static_cast<std::uint16_t>(fullmoves);
+
+    *this = result;
+    return true;
+}
+
+std::string Position::getFen() const {
+    std::string fen;
+    for (int row = 7; row >= 0; row--) {
+        int empty = 0;
+        for (int col = 0; col < 8; col++) {
+            int square = squareIndex(row, col);
+            if (isEmpty(square)) {
+                empty++;
+                continue;
+            }
+            if (empty != 0) {
+                fen += static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            char letter = pieceLetters[typeIndex(pieceOn(square))];
+            fen += colorOn(square) == pieceColor::white ? static_cast<char>(std::toupper(letter))
+                                                        : letter;
+        }
+        if (empty != 0) {
+            fen += static_cast<char>('0' + empty);
+        }
+        if (row != 0) {
+            fen += '/';
+        }
+    }
+
+    fen += sideToMove == pieceColor::white ? " w " : " b ";
+
+    if (castlingRights == 0) {
+        fen += '-';
+    }
+    if (castlingRights & whiteKingside) fen += 'K';
+    if (castlingRights & whiteQueenside) fen += 'Q';
+    if (castlingRights & blackKingside) fen += 'k';
+    if (castlingRights & blackQueenside) fen += 'q';
+
+    if (enPassant == noSquare) {
+        fen += " -";
+    } else {
+        fen += ' ';
+        fen += static_cast<char>('a' + colOf(enPassant));
+        fen += static_cast<char>('1' + rowOf(enPassant));
+    }
+
+    fen += ' ' + std::to_string(halfmoveClock) + ' ' + std::to_string(fullmoveNumber);
+    return fen;
+}
+
+pieceType Position::pieceOn(int square) const {
+    Bitboard bit = squareBit(square);
+    if (!(byType[0] & bit)) {
+        return pieceType::Base;
+    }
+    for (int type = typeIndex(pieceType::Pawn); type <= typeIndex(pieceType::Queen); type++) {
+        if (byType[type] & bit) {
+            return static_cast<pieceType>(type);
+        }
+    }
+    return pieceType::Base;
+}
+
+pieceColor Position::colorOn(int square) const {
+    return (byColor[colorIndex(pieceColor::black)] & squareBit(square))
+               ? pieceColor::black
+               : pieceColor::white;
+}
+
+int Position::kingSquare(pieceColor color) const {
+    Bitboard king = pieces(color, pieceType::King);
+    return king ? __builtin_ctzll(king) : noSquare;
+}
+
+void Position::setSideToMove(pieceColor color) {
+    if (color != sideToMove) {
+        key ^= zobrist.blackToMove;
+    }
+    sideToMove = color;
+}
+
+void Position::setCastlingRights(std::uint8_t rights) {
+    key ^= zobrist.castling[castlingRights] ^ zobrist.castling[rights];
+    castlingRights = rights;
+}
+
+void Position::setEnPassant(int square) {
+    if (enPassant != noSquare) {
+        key ^= zobrist.enPassantFile[colOf(enPassant)];
+    }
+    if (square != noSquare) {
+        key ^= zobrist.enPassantFile[colOf(square)];
+    }
+    enPassant = square;
+}
+
+// Hash from scratch, the incrementally updated key must always match it
+Key Position::computeKey() const {
+    Key result = zobrist.castling[castlingRights];
+    Bitboard occupied = pieces();
+    while (occupied) {
+        int square = __builtin_ctzll(occupied);
+        occupied &= occupied - 1;
+        result ^= zobrist.pieces[colorIndex(colorOn(square))][typeIndex(pieceOn(square))][square];
+    }
+    if (enPassant != noSquare) {
+        result ^= zobrist.enPassantFile[colOf(enPassant)];
+    }
+    if (sideToMove == pieceColor::black) {
+        result ^= zobrist.blackToMove;
+    }
+    return result;
+}
+
+// Material and piece square score for white, blended from the middlegame
+// to the endgame score as pieces come off. Promotions can push the phase
+// past a full middlegame
+float Position::evaluate() const {
+    int weight = std::min<int>(phase, maxPhase);
+    return (score.middlegame * weight + score.endgame * (maxPhase - weight)) / maxPhase;
+}
+
+void Position::putPiece(pieceColor color, pieceType type, int square) {
+    Bitboard bit = squareBit(square);
+    byType[0] |= bit;
+    byType[typeIndex(type)] |= bit;
+    byColor[colorIndex(color)] |= bit;
+    key ^= zobrist.pieces[colorIndex(color)][typeIndex(type)][square];
+    const TaperedScore &pieceScore = pieceSquareScores[colorIndex(color)][typeIndex(type)][square];
+    score.middlegame += pieceScore.middlegame;
+    score.endgame += pieceScore.endgame;
+    phase += phaseWeight[typeIndex(type)];
+}
+
+void Position::removePiece(pieceColor color, pieceType type, int square) {
+    Bitboard mask = ~squareBit(square);
+    byType[0] &= mask;
+    byType[typeIndex(type)] &= mask;
+    byColor[colorIndex(color)] &= mask;
+    key ^= zobrist.pieces[colorIndex(color)][typeIndex(type)][square];
+    const TaperedScore &pieceScore = pieceSquareScores[colorIndex(color)][typeIndex(type)][square];
+    score.middlegame -= pieceScore.middlegame;
+    score.endgame -= pieceScore.endgame;
+    phase -= phaseWeight[typeIndex(type)];
+}
+
+void Position::removePiece(int square) {
+    if (!isEmpty(square)) {
+        removePiece(colorOn(square), pieceOn(square), square);
+    }
+}
+
+// Every piece of either colour attacking square, computed outward from the
+// square: a piece attacks it exactly when the same piece standing on the
+// square would attack the piece back
+Bitboard Position::attackersTo(int square, Bitboard occupied) const {
+    return (pawnAttacks(pieceColor::white, square) & pieces(pieceColor::black, pieceType::Pawn)) |
+           (pawnAttacks(pieceColor::black, square) & pieces(pieceColor::white, pieceType::Pawn)) |
+           (knightAttacks(square) & pieces(pieceType::Knight)) |
+           (kingAttacks(square) & pieces(pieceType::King)) |
+           (rookAttacks(square, occupied) & (pieces(pieceType::Rook) | pieces(pieceType::Queen))) |
+           (bishopAttacks(square, occupied) & (pieces(pieceType::Bishop) | pieces(pieceType::Queen)));
+}
+
+bool Position::isSquareAttacked(int square, pieceColor by) const {
+    return attackersTo(square, pieces()) & pieces(by);
+}
+
+// Enemy pieces giving check to the side to move
+Bitboard Position::checkers() const {
+    int king = kingSquare(sideToMove);
+    return king == noSquare ? 0 : attackersTo(king, pieces()) & pieces(opposite(sideToMove));
+}
+
+bool Position::inCheck(pieceColor side) const {
+    int king = kingSquare(side);
+    return king != noSquare && isSquareAttacked(king, opposite(side));
+}
+
+void Position::makeMove(Move move, UndoInfo &undo) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    pieceColor color = sideToMove;
+    pieceColor enemy = opposite(color);
+    pieceType type = pieceOn(from);
+    int captureSquare = flagOf(move) == moveFlag::enPassant
+                            ? squareIndex(rowOf(from), colOf(to))
+                            : to;
+
+    undo.captured = isCapture(move) ? pieceOn(captureSquare) : pieceType::Base;
+    undo.castlingRights = castlingRights;
+    undo.enPassant = enPassant;
+    undo.halfmoveClock = halfmoveClock;
+    undo.key = key;
+
+    halfmoveClock = (type == pieceType::Pawn || isCapture(move)) ? 0 : halfmoveClock + 1;
+
+    // For en passant the taken pawn is behind the end square
+    if (isCapture(move)) {
+        removePiece(enemy, undo.captured, captureSquare);
+    }
+
+    removePiece(color, type, from);
+    putPiece(color, isPromotion(move) ? promotionType(move) : type, to);
+
+    // Rook must also be moved if move is castling
+    if (isCastling(move)) {
+        bool kingside = flagOf(move) == moveFlag::kingCastle;
+        int rookFrom = squareIndex(rowOf(from), kingside ? 7 : 0);
+        int rookTo = squareIndex(rowOf(from), kingside ? 5 : 3);
+        removePiece(color, pieceType::Rook, rookFrom);
+        putPiece(color, pieceType::Rook, rookTo);
+    }
+
+    // Pawn can be taken en passant immediately after its first move
+    setEnPassant(flagOf(move) == moveFlag::doublePush ? (from + to) / 2 : noSquare);
+
+    // Once any king/rook has moved or been taken, it can no longer castle
+    std::uint8_t lost = castlingRightsLost(from) | castlingRightsLost(to);
+    if (castlingRights & lost) {
+        setCastlingRights(castlingRights & ~lost);
+    }
+
+    if (color == pieceColor::black) {
+        fullmoveNumber++;
+    }
+    sideToMove = enemy;
+    key ^= zobrist.blackToMove;
+}
+
+// Exact inverse of makeMove, given the same move and the record it filled
+void Position::unmakeMove(Move move, const UndoInfo &undo) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    pieceColor color = opposite(sideToMove);
+    pieceType type = pieceOn(to);
+
+    removePiece(color, type, to);
+    putPiece(color, isPromotion(move) ? pieceType::Pawn : type, from);
+
+    if (isCastling(move)) {
+        bool kingside = flagOf(move) == moveFlag::kingCastle;
+        int rookFrom = squareIndex(rowOf(from), kingside ? 7 : 0);
+        int rookTo = squareIndex(rowOf(from), kingside ? 5 : 3);
+        removePiece(color, pieceType::Rook, rookTo);
+        putPiece(color, pieceType::Rook, rookFrom);
+    }
+
+    if (undo.captured != pieceType::Base) {
+        int captureSquare = flagOf(move) == moveFlag::enPassant
+                                ? squareIndex(rowOf(from), colOf(to))
+                                : to;
+        putPiece(sideToMove, undo.captured, captureSquare);
+    }
+
+    castlingRights = undo.castlingRights;
+    enPassant = undo.enPassant;
+    halfmoveClock = undo.halfmoveClock;
+    key = undo.key;
+    if (color == pieceColor::black) {
+        fullmoveNumber--;
+    }
+    sideToMove = color;
+}
@@ -0,0 +1,89 @@
+#ifndef Position_hpp
+#define Position_hpp
+
+#include "Evaluation.hpp"
+#include "Move.hpp"
+#include "Types.hpp"
+#include "Zobrist.hpp"
+#include <array>
+#include <string>
+#include <type_traits>
+
+inline constexpr const char *startFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Everything needed to take a move back that can't be recomputed from the
+// position after it. Plain data, lives on the caller's stack
+struct UndoInfo {
+    pieceType captured;
+    std::uint8_t castlingRights;
+    std::int8_t enPassant;
+    std::uint8_t halfmoveClock;
+    Key key;
+};
+
+// Compact value type holding the full state of a chess position
+// Copying a Position is a plain memcpy, so search can clone it freely
+class Position {
+  private:
+    // Indexed by pieceType, byType[Base] holds every occupied square
+    std::array<Bitboard, 7> byType;
+    std::array<Bitboard, 2> byColor;
+    pieceColor sideToMove;
+    std::uint8_t castlingRights;
+    // Square a pawn can capture onto en passant, noSquare if none
+    std::int8_t enPassant;
+    std::uint8_t halfmoveClock;
+    std::uint16_t fullmoveNumber;
+    // Zobrist hash, kept up to date by every change to the position
+    Key key;
+    // Sum of pieceSquareScores over every piece, also kept up to date
+    TaperedScore score;
+    std::uint8_t phase;
+
+    void removePiece(pieceColor color, pieceType type, int square);
+    void setCastlingRights(std::uint8_t rights);
+    void setEnPassant(int square);
+
+  public:
+    Position();
+    void clear();
+    void resetPosition();
+    bool setFen(const std::string &fen);
+    std::string getFen() const;
+
+    Bitboard pieces() const { return byType[0]; }
+    Bitboard pieces(pieceType type) const { return byType[typeIndex(type)]; }
+    Bitboard pieces(pieceColor color) const { return byColor[colorIndex(color)]; }
+    Bitboard pieces(pieceColor color, pieceType type) const {
+        return byType[typeIndex(type)] & byColor[colorIndex(color)];
+    }
+    pieceType pieceOn(int square) const;
+    pieceColor colorOn(int square) const;
+    bool isEmpty(int square) const { return !(byType[0] & squareBit(square)); }
+    int kingSquare(pieceColor color) const;
+
+    pieceColor getSideToMove() const { return sideToMove; }
+    void setSideToMove(pieceColor color);
+    std::uint8_t getCastlingRights() const { return castlingRights; }
+    int getEnPassant() const { return enPassant; }
+    int getHalfmoveClock() const { return halfmoveClock; }
+    int getFullmoveNumber() const { return fullmoveNumber; }
+    Key getKey() const { return key; }
+    Key computeKey() const;
+    float evaluate() const;
+
+    void putPiece(pieceColor color, pieceType type, int square);
+    void removePiece(int square);
+
+    Bitboard attackersTo(int square, Bitboard occupied) const;
+    bool isSquareAttacked(int square, pieceColor by) const;
+    Bitboard checkers() const;
+    bool inCheck(pieceColor side) const;
+    void makeMove(Move move, UndoInfo &undo);
+    void unmakeMove(Move move, const UndoInfo &undo);
+};
+
+static_assert(std::is_trivially_copyable_v<Position>);
+static_assert(sizeof(Position) <= 128, "Position should fit in two cache lines");
+
+#endif
@@ -0,0 +1,161 @@
+#include "TranspositionTable.hpp"
+#include <algorithm>
+#include <bit>
+
+// Score, move, depth, bound and generation packed into one 64 bit word
+static std::uint64_t packEntry(const TTEntry &entry) {
+    return static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(entry.score)) |
+           static_cast<std::uint64_t>(entry.move) << 32 |
+           static_cast<std::uint64_t>(static_cast<std::uint8_t>(entry.depth)) << 48 |
+           static_cast<std::uint64_t>(entry.boundAndGeneration) << 56;
+}
+
+static TTEntry unpackEntry(Key key, std::uint64_t data) {
+    TTEntry entry;
+    entry.key = key;
+    entry.score = std::bit_cast<float>(static_cast<std::uint32_t>(data));
+    entry.move = static_cast<Move>(data >> 32);
+    entry.depth = static_cast<std::int8_t>(data >> 48);
+    entry.boundAndGeneration = static_cast<std::uint8_t>(data >> 56);
+    return entry;
+}
+
+// Read a slot, recovering its key from the xored copy
+static TTEntry loadSlot(const TTSlot &slot) {
+    std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+    return unpackEntry(slot.keyXorData.load(std::memory_order_relaxed) ^ data, data);
+}
+
+TranspositionTable::TranspositionTable(std::size_t megabytes, replacementPolicy pPolicy) {
+    policy = pPolicy;
+    generation = 0;
+    this->resize(megabytes);
+}
+
+// Bucket count is rounded down to a power of two so the index is a mask
+void TranspositionTable::resize(std::size_t megabytes) {
+    std::size_t count = 1;
+    while (count * 2 * sizeof(TTBucket) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+    buckets = std::make_unique<TTBucket[]>(count);
+    bucketCount = count;
+    this->resetStatistics();
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < bucketCount; i++) {
+        for (auto &slot : buckets[i].slots) {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+    this->resetStatistics();
+}
+
+void TranspositionTable::newSearch() { generation = (generation + 1) & 63; }
+
+replacementPolicy TranspositionTable::getReplacementPolicy() { return policy; }
+
+void TranspositionTable::setReplacementPolicy(replacementPolicy newPolicy) {
+    policy = newPolicy;
+}
+
+bool TranspositionTable::probe(Key key, TTEntry &entry) {
+    TTBucket &bucket = buckets[key & (bucketCount - 1)];
+    for (auto &slot : bucket.slots) {
+        TTEntry candidate = loadSlot(slot);
+        if (candidate.key == key && candidate.getBound() != boundType::none) {
+            entry = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(Key key, int depth, float score, boundType bound, Move move) {
+    TTBucket &bucket = buckets[key & (bucketCount - 1)];
+    std::array<TTEntry, 4> entries;
+    for (int i = 0; i < 4; i++) {
+        entries[i] = loadSlot(bucket.slots[i]);
+    }
+
+    // Overwrite the entry for the same position if there is one
+    int victim = -1;
+    for (int i = 0; i < 4; i++) {
+        if (entries[i].key == key) {
+            victim = i;
+            break;
+        }
+    }
+
+    if (victim == -1 && policy == replacementPolicy::alwaysReplace) {
+        victim = static_cast<int>((key >> 32) & 3);
+    } else if (victim == -1) {
+        // Empty slots are worth least, then entries from older searches,
+        // then shallow ones
+        int lowestWorth = 0;
+        for (int i = 0; i < 4; i++) {
+            int age = (generation - entries[i].getGeneration()) & 63;
+            int worth =
+                entries[i].getBound() == boundType::none ? -1000 : entries[i].depth - 8 * age;
+            if (victim == -1 || worth < lowestWorth) {
+                victim = i;
+                lowestWorth = worth;
+            }
+        }
+    }
+
+    // Keep the old best move if this result didn't produce one
+    if (move == noMove && entries[victim].key == key) {
+        move = entries[victim].move;
+    }
+
+    TTEntry entry;
+    entry.key = key;
+    entry.score = score;
+    entry.move = move;
+    entry.depth = static_cast<std::int8_t>(depth);
+    entry.boundAndGeneration = static_cast<std::uint8_t>(static_cast<int>(bound) | (generation << 2));
+
+    std::uint64_t data = packEntry(entry);
+    bucket.slots[victim].keyXorData.store(key ^ data, std::memory_order_relaxed);
+    bucket.slots[victim].data.store(data, std::memory_order_relaxed);
+}
+
+std::size_t TranspositionTable::getSizeInBytes() { return bucketCount * sizeof(TTBucket); }
+
+void TranspositionTable::addStatistics(std::uint64_t newProbes, std::uint64_t newHits) {
+    probes += newProbes;
+    hits += newHits;
+}
+
+std::uint64_t TranspositionTable::getProbes() { return probes; }
+
+std::uint64_t TranspositionTable::getHits() { return hits; }
+
+double TranspositionTable::hitRate() {
+    return probes == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(probes);
+}
+
+// Permille of entries used by the current search, sampled from the first
+// thousand buckets like UCI's hashfull
+int TranspositionTable::hashfull() {
+    std::size_t sample = std::min<std::size_t>(bucketCount, 1000);
+    int used = 0;
+    for (std::size_t i = 0; i < sample; i++) {
+        for (auto &slot : buckets[i].slots) {
+            TTEntry entry = loadSlot(slot);
+            if (entry.getBound() != boundType::none && entry.getGeneration() == generation) {
+                used++;
+            }
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * 4));
+}
+
+void TranspositionTable::resetStatistics() {
+    probes = 0;
+    hits = 0;
+}
@@ -0,0 +1,80 @@
+#ifndef TranspositionTable_hpp
+#define TranspositionTable_hpp
+
+#include "Move.hpp"
+#include "Zobrist.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// How a stored score relates to the true score of the position
+enum class boundType : std::uint8_t { none, exact, lower, upper };
+
+enum class replacementPolicy {
+    // Keep the deepest results, replacing the shallowest or oldest entry
+    depthPreferred,
+    // Newest result always wins its slot in the bucket
+    alwaysReplace
+};
+
+struct TTEntry {
+    Key key;
+    float score;
+    Move move;
+    std::int8_t depth;
+    // Bound in the low 2 bits, search generation in the upper 6
+    std::uint8_t boundAndGeneration;
+
+    boundType getBound() const { return static_cast<boundType>(boundAndGeneration & 3); }
+    std::uint8_t getGeneration() const { return boundAndGeneration >> 2; }
+};
+
+// An entry as stored in the table, shared by every search thread without
+// locks. The entry is packed into one word and the key is stored xored with
+// it, so a slot torn by two threads writing at once fails the key check
+// instead of returning another position's data
+struct TTSlot {
+    std::atomic<std::uint64_t> keyXorData;
+    std::atomic<std::uint64_t> data;
+};
+
+// Four entries share one 64 byte cache line, so a probe touches one line
+struct alignas(64) TTBucket {
+    std::array<TTSlot, 4> slots;
+};
+
+static_assert(sizeof(TTBucket) == 64);
+
+class TranspositionTable {
+  private:
+    std::unique_ptr<TTBucket[]> buckets;
+    std::size_t bucketCount;
+    replacementPolicy policy;
+    // Bumped once per search so entries from earlier searches age out
+    std::uint8_t generation;
+    // Searches count probes themselves and add them in when they finish,
+    // so threads don't fight over these on every node
+    std::atomic<std::uint64_t> probes;
+    std::atomic<std::uint64_t> hits;
+
+  public:
+    TranspositionTable(std::size_t megabytes = 16,
+                       replacementPolicy pPolicy = replacementPolicy::depthPreferred);
+    void resize(std::size_t megabytes);
+    void clear();
+    void newSearch();
+    replacementPolicy getReplacementPolicy();
+    void setReplacementPolicy(replacementPolicy newPolicy);
+    bool probe(Key key, TTEntry &entry);
+    void store(Key key, int depth, float score, boundType bound, Move move);
+    std::size_t getSizeInBytes();
+    void addStatistics(std::uint64_t newProbes, std::uint64_t newHits);
+    std::uint64_t getProbes();
+    std::uint64_t getHits();
+    double hitRate();
+    int hashfull();
+    void resetStatistics();
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef Types_hpp
+#define Types_hpp
+
+#include <cstdint>
+
+enum class pieceColor { white, black };
+enum class pieceType { Base, Pawn, Rook, Knight, Bishop, King, Queen };
+
+// One bit per square, bit index = row * 8 + col (row 0 is white's back rank)
+using Bitboard = std::uint64_t;
+
+constexpr int noSquare = -1;
+
+constexpr int squareIndex(int row, int col) { return row * 8 + col; }
+
+constexpr int rowOf(int square) { return square >> 3; }
+
+constexpr int colOf(int square) { return square & 7; }
+
+constexpr Bitboard squareBit(int square) { return Bitboard(1) << square; }
+
+constexpr pieceColor opposite(pieceColor color) {
+    return color == pieceColor::white ? pieceColor::black : pieceColor::white;
+}
+
+constexpr int colorIndex(pieceColor color) { return static_cast<int>(color); }
+
+constexpr int typeIndex(pieceType type) { return static_cast<int>(type); }
+
+// Castling rights are stored as a 4 bit mask
+constexpr std::uint8_t whiteKingside = 1;
+constexpr std::uint8_t whiteQueenside = 2;
+constexpr std::uint8_t blackKingside = 4;
+constexpr std::uint8_t blackQueenside = 8;
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef Zobrist_hpp
+#define Zobrist_hpp
+
+#include "Types.hpp"
+#include <array>
+
+using Key = std::uint64_t;
+
+// Random keys XORed together to give each position a 64 bit hash
+struct ZobristKeys {
+    // Indexed by colour, pieceType and square
+    std::array<std::array<std::array<Key, 64>, 7>, 2> pieces;
+    // Indexed by the full castling rights mask
+    std::array<Key, 16> castling;
+    std::array<Key, 8> enPassantFile;
+    Key blackToMove;
+};
+
+// SplitMix64, good enough to fill the tables and usable at compile time
+constexpr Key nextZobristKey(Key &state) {
+    Key z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys makeZobristKeys() {
+    ZobristKeys keys = {};
+    Key state = 0x2545F4914F6CDD1DULL;
+    for (auto &colorKeys : keys.pieces) {
+        for (auto &typeKeys : colorKeys) {
+            for (auto &key : typeKeys) {
+                key = nextZobristKey(state);
+            }
+        }
+    }
+    // Castling keys combine per-right keys so each right toggles independently
+    std::array<Key, 4> rightKeys = {};
+    for (auto &key : rightKeys) {
+        key = nextZobristKey(state);
+    }
+    for (int rights = 0; rights < 16; rights++) {
+        for (int right = 0; right < 4; right++) {
+            if (rights & (1 << right)) {
+                keys.castling[rights] ^= rightKeys[right];
+            }
+        }
+    }
+    for (auto &key : keys.enPassantFile) {
+        key = nextZobristKey(state);
+    }
+    keys.blackToMove = nextZobristKey(state);
+    return keys;
+}
+
+inline constexpr ZobristKeys zobrist = makeZobristKeys();
+
+#endif
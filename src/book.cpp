@@ -0,0 +1,148 @@
+#include "Notation.hpp"
+#include "OpeningBook.hpp"
+#include "Polyglot.hpp"
+#include "Position.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Move in SAN or UCI notation, noMove if it isn't a legal move
+Move parseMove(const Position &position, const std::string &text) {
+    Move move = moveFromUci(position, text);
+    return move != noMove ? move : moveFromSan(position, text);
+}
+
+bool isResult(const std::string &text) {
+    return text == "1-0" || text == "0-1" || text == "1/2-1/2" || text == "*";
+}
+
+// Every line of the input is one game, move numbers such as 1. or 1...
+// are skipped and a game ends at its result or at a move that can't be
+// read. Each position reached in the first plies plies gets the move
+// played from it, weighted by how often it was played there
+int buildBook(const std::string &inputPath, const std::string &outputPath, int plies) {
+    std::ifstream input(inputPath);
+    if (!input) {
+        std::cout << "Can't read " << inputPath << std::endl;
+        return 1;
+    }
+
+    std::map<std::pair<Key, std::uint16_t>, int> counts;
+    std::string line;
+    int games = 0;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        std::istringstream tokens(line);
+        Position position;
+        position.resetPosition();
+        std::string token;
+        int ply = 0;
+        while (ply < plies && tokens >> token) {
+            token = token.substr(token.find_last_of('.') + 1);
+            if (token.empty()) {
+                continue;
+            }
+            Move move = parseMove(position, token);
+            if (move == noMove) {
+                if (!isResult(token)) {
+                    std::cout << "Skipping rest of line " << lineNumber << " at " << token
+                              << std::endl;
+                }
+                break;
+            }
+            counts[{polyglotKey(position), encodeBookMove(move)}]++;
+            UndoInfo undo;
+            position.makeMove(move, undo);
+            ply++;
+        }
+        games += ply > 0;
+    }
+
+    std::vector<BookEntry> entries;
+    for (auto &[position, count] : counts) {
+        entries.push_back({position.first, position.second,
+                           static_cast<std::uint16_t>(std::min(count, 65535)), 0});
+    }
+    if (!writeBook(outputPath, entries)) {
+        std::cout << "Can't write " << outputPath << std::endl;
+        return 1;
+    }
+    std::cout << entries.size() << " entries from " << games << " games written to "
+              << outputPath << std::endl;
+    return 0;
+}
+
+// Book moves for a position with their share of the weight
+int probeBook(const std::string &bookPath, const std::string &fen) {
+    OpeningBook book;
+    if (!book.open(bookPath)) {
+        std::cout << "Can't open " << bookPath << std::endl;
+        return 1;
+    }
+    Position position;
+    if (!position.setFen(fen)) {
+        std::cout << "Invalid FEN: " << fen << std::endl;
+        return 1;
+    }
+
+    std::cout << "key " << std::hex << std::setfill('0') << std::setw(16)
+              << polyglotKey(position) << std::dec << std::endl;
+    auto moves = book.probeAll(position);
+    int totalWeight = 0;
+    for (auto &[move, weight] : moves) {
+        totalWeight += weight;
+    }
+    for (auto &[move, weight] : moves) {
+        std::cout << moveToSan(position, move) << " " << weight << " ("
+                  << (totalWeight != 0 ? weight * 100 / totalWeight : 0) << "%)" << std::endl;
+    }
+    if (moves.empty()) {
+        std::cout << "Not in book" << std::endl;
+    }
+    return 0;
+}
+
+void printUsage() {
+    std::cout << "usage: book <games> <book> [plies]  build a book from games, one per line in SAN or UCI,"
+              << std::endl
+              << "                                  up to plies deep, 20 by default"
+              << std::endl
+              << "       book --probe <book> [fen]  list the book moves, start position by default"
+              << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    if (command == "--probe") {
+        // FEN fields may arrive as separate arguments
+        std::string fen = startFen;
+        if (argc > 3) {
+            fen = argv[3];
+            for (int i = 4; i < argc; i++) {
+                fen += ' ';
+                fen += argv[i];
+            }
+        }
+        return probeBook(argv[2], fen);
+    }
+
+    int plies = argc > 3 ? std::atoi(argv[3]) : 20;
+    if (plies < 1) {
+        printUsage();
+        return 1;
+    }
+    return buildBook(argv[1], argv[2], plies);
+}
@@ -3,11 +3,19 @@
 #include "Piece.hpp"
 #include "Square.hpp"
 #include "Opponent.hpp"
+#include "Engine.hpp"
+#include "Notation.hpp"
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <iostream>
 #include <chrono>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <thread>
 
 void close(SDL_Window *win, SDL_Renderer *renderer) {
     SDL_DestroyRenderer(renderer);
@@ -17,84 +25,222 @@ void close(SDL_Window *win, SDL_Renderer *renderer) {
     SDL_Quit();
 }
 
-void drawPiece(SDL_Renderer *renderer, const char *imgName, int row, int col) {
+// Textures drawn more than once are created once at startup and reused, so
+// a redraw is only blits
+struct Graphics {
+    SDL_Renderer *renderer = nullptr;
+    TTF_Font *font = nullptr;
+    // Piece images keyed by file name
+    std::map<std::string, SDL_Texture *> images;
+    // Rendered text keyed by colour and string
+    std::map<std::string, SDL_Texture *> text;
+    // Squares and pieces of the board, kept between frames so only squares
+    // that changed are drawn again. Null if the renderer can't draw to
+    // textures, then the whole board is drawn every frame
+    SDL_Texture *boardLayer = nullptr;
+    // What each square of the board layer shows, indexed by square
+    std::array<const char *, 64> drawnImages;
+    std::array<bool, 64> drawnSelected;
+    std::array<bool, 64> drawnValid;
+};
+
+SDL_Texture *loadImage(SDL_Renderer *renderer, const char *imgName) {
     SDL_Surface *image = IMG_Load(imgName);
-    SDL_Texture *imageTexture = SDL_CreateTextureFromSurface(renderer, image);
+    if (image == nullptr) {
+        return nullptr;
+    }
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, image);
+    SDL_FreeSurface(image);
+    return texture;
+}
+
+std::string textKey(const char *text, std::array<int, 3> color) {
+    return std::to_string(color[0]) + "," + std::to_string(color[1]) + "," +
+           std::to_string(color[2]) + ":" + text;
+}
+
+// Rendered on first use, every fixed string is rendered at startup
+SDL_Texture *textTexture(Graphics &graphics, const char *text, std::array<int, 3> color) {
+    std::string key = textKey(text, color);
+    auto cached = graphics.text.find(key);
+    if (cached != graphics.text.end()) {
+        return cached->second;
+    }
+
+    SDL_Color textColor = {static_cast<Uint8>(color[0]),
+                           static_cast<Uint8>(color[1]),
+                           static_cast<Uint8>(color[2])};
+    SDL_Surface *textSurface = TTF_RenderText_Solid(graphics.font, text, textColor);
+    SDL_Texture *texture = nullptr;
+    if (textSurface != nullptr) {
+        texture = SDL_CreateTextureFromSurface(graphics.renderer, textSurface);
+        SDL_FreeSurface(textSurface);
+    }
+    graphics.text[key] = texture;
+    return texture;
+}
+
+// Mark every square of the board layer as needing a redraw
+void invalidateBoard(Graphics &graphics) { graphics.drawnValid.fill(false); }
+
+Graphics loadGraphics(SDL_Renderer *renderer) {
+    Graphics graphics;
+    graphics.renderer = renderer;
+    graphics.font = TTF_OpenFont("assets/chess.ttf", 12);
+
+    for (auto color : {pieceColor::white, pieceColor::black}) {
+        for (auto type : {pieceType::Pawn, pieceType::Rook, pieceType::Knight,
+                          pieceType::Bishop, pieceType::King, pieceType::Queen}) {
+            const char *imgName = Piece(color, type).getImageName();
+            graphics.images[imgName] = loadImage(renderer, imgName);
+        }
+    }
+
+    const std::array<int, 3> white = {255, 255, 255};
+    const std::array<int, 3> black = {0, 0, 0};
+    const std::array<int, 3> red = {255, 0, 0};
+    for (auto text : {"Black's turn", "White's turn", "Thinking", "Black in check",
+                      "White in check"}) {
+        textTexture(graphics, text, white);
+    }
+    for (auto text : {"Choose Opponent:", "Player", "Computer", "START", "REPLAY", "UNDO"}) {
+        textTexture(graphics, text, black);
+    }
+    for (auto text : {"BLACK CHECKMATE", "WHITE CHECKMATE", "STALEMATE"}) {
+        textTexture(graphics, text, red);
+    }
+
+    if (SDL_RenderTargetSupported(renderer)) {
+        graphics.boardLayer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                                SDL_TEXTUREACCESS_TARGET, 400, 400);
+    }
+    invalidateBoard(graphics);
+    return graphics;
+}
+
+void freeGraphics(Graphics &graphics) {
+    for (auto &[name, texture] : graphics.images) {
+        SDL_DestroyTexture(texture);
+    }
+    for (auto &[key, texture] : graphics.text) {
+        SDL_DestroyTexture(texture);
+    }
+    graphics.images.clear();
+    graphics.text.clear();
+    if (graphics.boardLayer != nullptr) {
+        SDL_DestroyTexture(graphics.boardLayer);
+        graphics.boardLayer = nullptr;
+    }
+    if (graphics.font != nullptr) {
+        TTF_CloseFont(graphics.font);
+        graphics.font = nullptr;
+    }
+}
+
+void drawPiece(Graphics &graphics, const char *imgName, int row, int col) {
+    auto image = graphics.images.find(imgName);
+    if (image == graphics.images.end()) {
+        return;
+    }
     SDL_Rect pieceRect;
     pieceRect.x = col;
     pieceRect.y = row;
     pieceRect.w = 50;
     pieceRect.h = 50;
-    SDL_RenderCopy(renderer, imageTexture, NULL, &pieceRect);
-    SDL_DestroyTexture(imageTexture);
+    SDL_RenderCopy(graphics.renderer, image->second, NULL, &pieceRect);
 }
 
-void drawText(SDL_Renderer *renderer, const char *text, int x, int y,
+void drawText(Graphics &graphics, const char *text, int x, int y,
               std::array<int, 3> color, int height = 0, int width = 0) {
-    SDL_Color textColor = {static_cast<Uint8>(color[0]),
-                           static_cast<Uint8>(color[1]),
-                           static_cast<Uint8>(color[2])};
-    TTF_Font *font = TTF_OpenFont("assets/chess.ttf", 12);
-    SDL_Surface *textSurface = TTF_RenderText_Solid(font, text, textColor);
-    SDL_Texture *textTexture =
-        SDL_CreateTextureFromSurface(renderer, textSurface);
+    SDL_Texture *texture = textTexture(graphics, text, color);
+    if (texture == nullptr) {
+        return;
+    }
+    int textWidth = 0;
+    int textHeight = 0;
+    SDL_QueryTexture(texture, NULL, NULL, &textWidth, &textHeight);
     SDL_Rect r;
     r.x = x;
     r.y = y;
-    r.w = width != 0 ? width : textSurface->w;
-    r.h = height != 0 ? height : textSurface->h;
-    SDL_RenderCopy(renderer, textTexture, NULL, &r);
-    SDL_DestroyTexture(textTexture);
-    TTF_CloseFont(font);
+    r.w = width != 0 ? width : textWidth;
+    r.h = height != 0 ? height : textHeight;
+    SDL_RenderCopy(graphics.renderer, texture, NULL, &r);
 }
 
-void draw(SDL_Renderer *renderer, std::shared_ptr<Board> board,
-          std::shared_ptr<Square> selectedSquare, std::shared_ptr<Game> game,
-          bool buttonPressed, bool showPromotionMenu) {
-    SDL_SetRenderDrawColor(renderer, 241, 221, 206, 255);
-    SDL_RenderClear(renderer);
+// Bring the board layer up to date, drawing only squares whose piece or
+// highlight changed since the last frame, then copy it to the window
+void drawBoard(Graphics &graphics, std::shared_ptr<Board> board,
+               std::shared_ptr<Square> selectedSquare) {
+    SDL_Renderer *renderer = graphics.renderer;
+    bool useLayer = graphics.boardLayer != nullptr;
+    if (useLayer) {
+        SDL_SetRenderTarget(renderer, graphics.boardLayer);
+    }
 
-    // Draw squares
-    SDL_Rect r;
-    bool isBlackSquare = false;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (board->getSquare(7 - i, j) == selectedSquare) {
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            auto square = board->getSquare(row, col);
+            auto piece = square->getPiece();
+            const char *image = piece != nullptr ? piece->getImageName() : nullptr;
+            bool selected = square == selectedSquare;
+            int index = squareIndex(row, col);
+            if (useLayer && graphics.drawnValid[index] &&
+                graphics.drawnImages[index] == image && graphics.drawnSelected[index] == selected) {
+                continue;
+            }
+
+            if (selected) {
                 SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-            } else if (isBlackSquare) {
+            } else if ((row + col) % 2 == 0) {
                 SDL_SetRenderDrawColor(renderer, 97, 61, 61, 255);
             } else {
                 SDL_SetRenderDrawColor(renderer, 241, 221, 206, 255);
             }
-            isBlackSquare = !isBlackSquare;
-
-            r.x = j * 50;
-            r.y = i * 50;
+            SDL_Rect r;
+            r.x = col * 50;
+            r.y = (7 - row) * 50;
             r.w = 50;
             r.h = 50;
             SDL_RenderFillRect(renderer, &r);
+            if (image != nullptr) {
+                drawPiece(graphics, image, r.y, r.x);
+            }
+
+            graphics.drawnImages[index] = image;
+            graphics.drawnSelected[index] = selected;
+            graphics.drawnValid[index] = true;
         }
-        isBlackSquare = !isBlackSquare;
     }
 
+    if (useLayer) {
+        SDL_SetRenderTarget(renderer, NULL);
+        SDL_Rect boardRect;
+        boardRect.x = 0;
+        boardRect.y = 0;
+        boardRect.w = 400;
+        boardRect.h = 400;
+        SDL_RenderCopy(renderer, graphics.boardLayer, NULL, &boardRect);
+    }
+}
+
+void draw(Graphics &graphics, std::shared_ptr<Board> board,
+          std::shared_ptr<Square> selectedSquare, std::shared_ptr<Game> game,
+          bool buttonPressed, bool showPromotionMenu) {
+    SDL_Renderer *renderer = graphics.renderer;
+    SDL_SetRenderDrawColor(renderer, 241, 221, 206, 255);
+    SDL_RenderClear(renderer);
+
+    // Draw squares and pieces
+    drawBoard(graphics, board, selectedSquare);
+
+    SDL_Rect r;
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     r.x = 0;
     r.y = 400;
     r.w = 400, r.h = 50;
     SDL_RenderFillRect(renderer, &r);
 
-    // Draw pieces
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            auto currentPiece = board->getSquare(i, j)->getPiece();
-            if (currentPiece != nullptr) {
-                drawPiece(renderer, currentPiece->getImageName(), 50 * (7 - i),
-                          50 * j);
-            }
-        }
-    }
-
-    drawText(renderer,
+    drawText(graphics,
              game->getCurrentTurn() == pieceColor::black ? "Black's turn"
                                                          : "White's turn",
              5, 405, {255, 255, 255});
@@ -104,18 +250,19 @@ void draw(SDL_Renderer *renderer, std::shared_ptr<Board> board,
         (game->getStatus() == gameStatus::inProgress ||
          game->getStatus() == gameStatus::blackCheck ||
          game->getStatus() == gameStatus::whiteCheck)) {
-            drawText(renderer, "Thinking", 320, 417, {255, 255, 255});
+            drawText(graphics, "Thinking", 320, 417, {255, 255, 255});
          }
 
     if (game->getStatus() == gameStatus::blackCheck) {
-        drawText(renderer, "Black in check", 5, 425, {255, 255, 255});
+        drawText(graphics, "Black in check", 5, 425, {255, 255, 255});
     } else if (game->getStatus() == gameStatus::whiteCheck) {
-        drawText(renderer, "White in check", 5, 425, {255, 255, 255});
+        drawText(graphics, "White in check", 5, 425, {255, 255, 255});
     }
 
     // Draw start/replay button
     if (game->getStatus() == gameStatus::blackCheckmate ||
         game->getStatus() == gameStatus::whiteCheckmate || 
+        game->getStatus() == gameStatus::stalemate ||
         game->getStatus() == gameStatus::startScreen) {
             SDL_SetRenderDrawColor(renderer, 169, 169, 169, 255);
             r.x = 110;
@@ -126,7 +273,7 @@ void draw(SDL_Renderer *renderer, std::shared_ptr<Board> board,
             SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
             SDL_RenderDrawRect(renderer, &r);
 
-            drawText(renderer, "Choose Opponent:", 115, 151, {0, 0, 0});
+            drawText(graphics, "Choose Opponent:", 115, 151, {0, 0, 0});
 
             r.x = 120; r.y = 171; r.w = 10; r.h = 10;
             if (game->getOpponent() == opponents::player) {
@@ -140,8 +287,8 @@ void draw(SDL_Renderer *renderer, std::shared_ptr<Board> board,
                 SDL_RenderFillRect(renderer, &r);
             }
 
-            drawText(renderer, "Player", 135, 169, {0, 0, 0});
-            drawText(renderer, "Computer", 135, 189, {0, 0, 0});
+            drawText(graphics, "Player", 135, 169, {0, 0, 0});
+            drawText(graphics, "Computer", 135, 189, {0, 0, 0});
 
             if (buttonPressed) {
                 SDL_SetRenderDrawColor(renderer, 211, 211, 211, 255);
@@ -157,10 +304,12 @@ void draw(SDL_Renderer *renderer, std::shared_ptr<Board> board,
             SDL_RenderDrawRect(renderer, &r);
 
             if (game->getStatus() == gameStatus::startScreen) {
-                drawText(renderer, "START", 167, 215, {0, 0, 0}, 30, 65);
+                drawText(graphics, "START", 167, 215, {0, 0, 0}, 30, 65);
             } else {
-                drawText(renderer, "REPLAY", 167, 215, {0, 0, 0}, 30, 65);
-                drawText(renderer, game->getStatus() == gameStatus::blackCheckmate ? "BLACK CHECKMATE" : "WHITE CHECKMATE", 
+                drawText(graphics, "REPLAY", 167, 215, {0, 0, 0}, 30, 65);
+                drawText(graphics, game->getStatus() == gameStatus::blackCheckmate ? "BLACK CHECKMATE"
+                                   : game->getStatus() == gameStatus::whiteCheckmate ? "WHITE CHECKMATE"
+                                                                                     : "STALEMATE",
                     255, 402, {255, 0, 0}, 50);
             }
     }
@@ -177,7 +326,7 @@ void draw(SDL_Renderer *renderer, std::shared_ptr<Board> board,
         r.h = 19;
         SDL_RenderFillRect(renderer, &r);
 
-        drawText(renderer, "UNDO", 346, 417, {0, 0, 0});
+        drawText(graphics, "UNDO", 346, 417, {0, 0, 0});
     }
 
     // Draw promotion menu
@@ -190,34 +339,18 @@ void draw(SDL_Renderer *renderer, std::shared_ptr<Board> board,
         SDL_RenderFillRect(renderer, &r);
 
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        drawPiece(
-            renderer,
-            (std::string("assets/") +
-             (game->getCurrentTurn() == pieceColor::white ? "wht" : "blk") +
-             "Queen.png")
-                .c_str(),
-            175, 97);
-        drawPiece(
-            renderer,
-            (std::string("assets/") +
-             (game->getCurrentTurn() == pieceColor::white ? "wht" : "blk") +
-             "Rook.png")
-                .c_str(),
-            175, 149);
-        drawPiece(
-            renderer,
-            (std::string("assets/") +
-             (game->getCurrentTurn() == pieceColor::white ? "wht" : "blk") +
-             "Bishop.png")
-                .c_str(),
-            175, 201);
-        drawPiece(
-            renderer,
-            (std::string("assets/") +
-             (game->getCurrentTurn() == pieceColor::white ? "wht" : "blk") +
-             "Knight.png")
-                .c_str(),
-            175, 253);
+        drawPiece(graphics,
+                  Piece(game->getCurrentTurn(), pieceType::Queen).getImageName(),
+                  175, 97);
+        drawPiece(graphics,
+                  Piece(game->getCurrentTurn(), pieceType::Rook).getImageName(),
+                  175, 149);
+        drawPiece(graphics,
+                  Piece(game->getCurrentTurn(), pieceType::Bishop).getImageName(),
+                  175, 201);
+        drawPiece(graphics,
+                  Piece(game->getCurrentTurn(), pieceType::Knight).getImageName(),
+                  175, 253);
 
         r.x = 96;
         r.y = 174;
@@ -235,6 +368,17 @@ int main(int argc, char *argv[]) {
     int width = 400;
     int height = 450;
 
+    // Computer searches on every core unless told otherwise
+    int searchThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    // chess --threads n sets the computer's search threads
+    if (argc > 2 && std::string(argv[1]) == "--threads") {
+        searchThreads = std::max(1, std::atoi(argv[2]));
+    }
+
+    // Optional, without a book every move is searched
+    getOpeningBook().open("assets/book.bin");
+
     std::shared_ptr<Game> game = std::make_shared<Game>(Game());
 
     std::shared_ptr<Square> selectedSquare = nullptr;
@@ -247,37 +391,76 @@ int main(int argc, char *argv[]) {
                                        SDL_WINDOWPOS_UNDEFINED, width, height,
                                        SDL_WINDOW_SHOWN);
     SDL_Renderer *renderer =
-        SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED);
+        SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
     SDL_Surface *iconSurface = IMG_Load("assets/appIcon.png");
     SDL_SetWindowIcon(win, iconSurface);
+    SDL_FreeSurface(iconSurface);
+
+    Graphics graphics = loadGraphics(renderer);
 
     SDL_Event event;
     bool isQuit = false;
 
     bool buttonPressed = false;
 
-    draw(renderer, game->getBoard(), selectedSquare, game, buttonPressed,
+    draw(graphics, game->getBoard(), selectedSquare, game, buttonPressed,
          game->getStatus() == gameStatus::choosingPromotion);
 
+    // Computer's moves are searched in the background so the window keeps
+    // handling events while it thinks
+    Engine engine;
+    int reportedDepth = 0;
+
     while (!isQuit) {
-        // If playing computer, call method to determine computer move
+        // If playing computer, start searching for its move
         if ((game->getStatus() == gameStatus::inProgress ||
              game->getStatus() == gameStatus::blackCheck ||
              game->getStatus() == gameStatus::whiteCheck) && 
             game->getOpponent() == opponents::computer && 
-            game->getCurrentTurn() == pieceColor::black) {
-                auto start = std::chrono::high_resolution_clock::now();
-                opponentTurn(game);
-                auto end = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-                std::cout << duration.count() << std::endl;
-                
-                game->setCurrentTurn(pieceColor::white);
-                draw(renderer, game->getBoard(), selectedSquare, game,
-                     buttonPressed,
-                     game->getStatus() == gameStatus::choosingPromotion);
+            game->getCurrentTurn() == pieceColor::black && !engine.isBusy()) {
+                SearchLimits limits;
+                limits.threads = searchThreads;
+                engine.start(game->getBoard()->getPosition(), limits);
+                reportedDepth = 0;
+            }
+
+        // Report each iteration as it completes, then play the move
+        if (engine.isBusy()) {
+            SearchResult progress = engine.getProgress();
+            if (progress.depth > reportedDepth) {
+                reportedDepth = progress.depth;
+                std::cout << "depth " << progress.depth << " score " << progress.score
+                          << " nodes " << progress.nodes << " time " << progress.elapsed.count()
+                          << "ms pv";
+                Position line = game->getBoard()->getPosition();
+                for (auto move : progress.principalVariation) {
+                    std::cout << ' ' << moveToSan(line, move);
+                    UndoInfo undo;
+                    line.makeMove(move, undo);
+                }
+                std::cout << std::endl;
             }
-        else if (SDL_PollEvent(&event)) {
+        }
+        SearchResult result;
+        if (engine.poll(result)) {
+            if (result.bestMove != noMove) {
+                game->playMove(result.bestMove);
+            }
+            if (result.depth == 0 && result.bestMove != noMove) {
+                std::cout << "book move" << std::endl;
+            }
+            std::cout << result.elapsed.count() << "ms depth " << result.depth
+                      << " nodes " << result.nodes << std::endl;
+            std::cout << "tt hit rate " << getTranspositionTable().hitRate()
+                      << " hashfull " << getTranspositionTable().hashfull() << std::endl;
+
+            draw(graphics, game->getBoard(), selectedSquare, game,
+                 buttonPressed,
+                 game->getStatus() == gameStatus::choosingPromotion);
+        }
+
+        // Wait briefly for events so the loop doesn't spin
+        if (SDL_WaitEventTimeout(&event, 10)) {
             if (event.type == SDL_QUIT) {
                 isQuit = true;
             } else if (event.type == SDL_MOUSEBUTTONDOWN) {
@@ -287,6 +470,7 @@ int main(int argc, char *argv[]) {
                 // Click on start/replay button
                 if ((game->getStatus() == gameStatus::blackCheckmate ||
                      game->getStatus() == gameStatus::whiteCheckmate ||
+                     game->getStatus() == gameStatus::stalemate ||
                      game->getStatus() == gameStatus::startScreen) &&
                     (event.button.x >= 160 && event.button.x <= 240 &&
                      event.button.y >= 212 && event.button.y <= 246)) {
@@ -295,12 +479,14 @@ int main(int argc, char *argv[]) {
                 // Click on opponent selection
                 else if ((game->getStatus() == gameStatus::blackCheckmate ||
                           game->getStatus() == gameStatus::whiteCheckmate ||
+                          game->getStatus() == gameStatus::stalemate ||
                           game->getStatus() == gameStatus::startScreen) &&
                          (event.button.x >= 120 && event.button.x <= 190 &&
                           event.button.y >= 171 && event.button.y <= 181)) {
                             game->setOpponent(opponents::player);
                 } else if ((game->getStatus() == gameStatus::blackCheckmate ||
                             game->getStatus() == gameStatus::whiteCheckmate ||
+                            game->getStatus() == gameStatus::stalemate ||
                             game->getStatus() == gameStatus::startScreen) &&
                            (event.button.x >= 120 && event.button.x <= 210 &&
                             event.button.y >= 191 && event.button.y <= 201)) {
@@ -326,13 +512,21 @@ int main(int argc, char *argv[]) {
                 // Click on undo move button 
                 else if (event.button.x >= 344 && event.button.x <= 388 &&
                            event.button.y >= 415 && event.button.y <= 434) {
-                    game->undoMove();
-                    if (game->getOpponent() == opponents::computer) {
+                    // Computer hasn't replied yet, only the player's move
+                    // needs taking back
+                    if (engine.isBusy()) {
+                        engine.cancel();
                         game->undoMove();
+                    } else {
+                        game->undoMove();
+                        if (game->getOpponent() == opponents::computer) {
+                            game->undoMove();
+                        }
                     }
                 } 
-                // Click on chess board
-                else if (clickedCol >= 0 && clickedCol <= 7 &&
+                // Click on chess board, ignored while the computer thinks
+                else if (!engine.isBusy() &&
+                         clickedCol >= 0 && clickedCol <= 7 &&
                            clickedRow >= 0 && clickedRow <= 7) {
                     auto clickedSquare =
                         game->getBoard()->getSquare(clickedRow, clickedCol);
@@ -356,25 +550,41 @@ int main(int argc, char *argv[]) {
                     }
                 }
 
-                draw(renderer, game->getBoard(), selectedSquare, game,
+                draw(graphics, game->getBoard(), selectedSquare, game,
                      buttonPressed,
                      game->getStatus() == gameStatus::choosingPromotion);
             } else if (event.type == SDL_MOUSEBUTTONUP) {
                 // Start new game if start/replay button is pressed
                 if (buttonPressed) {
                     buttonPressed = false;
-                    draw(renderer, game->getBoard(), selectedSquare, game,
+                    draw(graphics, game->getBoard(), selectedSquare, game,
                          buttonPressed,
                          game->getStatus() == gameStatus::choosingPromotion);
+                    engine.cancel();
                     game->resetGame();
-                    draw(renderer, game->getBoard(), selectedSquare, game,
+                    draw(graphics, game->getBoard(), selectedSquare, game,
                          buttonPressed,
                          game->getStatus() == gameStatus::choosingPromotion);
                 }
+            } else if (event.type == SDL_RENDER_TARGETS_RESET ||
+                       event.type == SDL_RENDER_DEVICE_RESET) {
+                // A lost device takes every texture with it, so they are
+                // made again. Either way the board layer's contents are
+                // lost, draw every square again
+                if (event.type == SDL_RENDER_DEVICE_RESET) {
+                    freeGraphics(graphics);
+                    graphics = loadGraphics(renderer);
+                }
+                invalidateBoard(graphics);
+                draw(graphics, game->getBoard(), selectedSquare, game,
+                     buttonPressed,
+                     game->getStatus() == gameStatus::choosingPromotion);
             }
         }
     }
 
+    engine.cancel();
+    freeGraphics(graphics);
     close(win, renderer);
 
     return 0;
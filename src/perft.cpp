@@ -0,0 +1,164 @@
+#include "MoveGen.hpp"
+#include "Notation.hpp"
+#include "Position.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Reference positions with their known node counts for depth 1, 2, 3...
+// from the Chess Programming Wiki perft results page, plus FEN edge cases
+struct PerftCase {
+    const char *name;
+    const char *fen;
+    std::vector<std::uint64_t> counts;
+};
+
+const std::array<PerftCase, 8> perftSuite = {{
+    {"startpos", startFen, {20, 400, 8902, 197281, 4865609}},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+     {48, 2039, 97862, 4085603}},
+    {"position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+     {14, 191, 2812, 43238, 674624, 11030083}},
+    {"position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+     {6, 264, 9467, 422333}},
+    {"position 4 mirrored", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+     {6, 264, 9467, 422333}},
+    {"position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+     {44, 1486, 62379, 2103487}},
+    {"position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+     {46, 2079, 89890, 3894594}},
+    // No white pawn on e4, so the FEN's en passant square has to be dropped
+    // and counts match the same position without one
+    {"bogus en passant", "4k3/8/8/8/3p4/8/8/4K3 b - e3 0 1", {6, 29, 218, 1274, 9906, 59345}},
+}};
+
+// Count the leaf nodes of the legal move tree, moves at the last ply are
+// counted without being made
+std::uint64_t perft(Position &position, int depth) {
+    if (depth == 0) {
+        return 1;
+    }
+
+    MoveList moves;
+    generateMoves(position, moves);
+    if (depth == 1) {
+        return moves.size();
+    }
+
+    std::uint64_t nodes = 0;
+    for (auto move : moves) {
+        UndoInfo undo;
+        position.makeMove(move, undo);
+        nodes += perft(position, depth - 1);
+        position.unmakeMove(move, undo);
+    }
+    return nodes;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Node count below each root move, then the total
+void divide(Position &position, int depth) {
+    auto start = std::chrono::steady_clock::now();
+    MoveList moves;
+    generateMoves(position, moves);
+
+    std::uint64_t total = 0;
+    for (auto move : moves) {
+        UndoInfo undo;
+        position.makeMove(move, undo);
+        std::uint64_t nodes = perft(position, depth - 1);
+        position.unmakeMove(move, undo);
+        std::cout << moveToUci(move) << ": " << nodes << std::endl;
+        total += nodes;
+    }
+
+    double seconds = secondsSince(start);
+    std::cout << std::endl
+              << "Nodes: " << total << std::endl
+              << "Time: " << seconds * 1000 << "ms" << std::endl
+              << "NPS: " << static_cast<std::uint64_t>(total / seconds) << std::endl;
+}
+
+// Run every reference position up to maxDepth, returns false on any mismatch
+bool runSuite(int maxDepth) {
+    bool passed = true;
+    std::uint64_t totalNodes = 0;
+    auto suiteStart = std::chrono::steady_clock::now();
+
+    for (auto &test : perftSuite) {
+        Position position;
+        position.setFen(test.fen);
+        for (int depth = 1; depth <= std::min<int>(maxDepth, test.counts.size()); depth++) {
+            auto start = std::chrono::steady_clock::now();
+            std::uint64_t nodes = perft(position, depth);
+            double seconds = secondsSince(start);
+            std::uint64_t expected = test.counts[depth - 1];
+            totalNodes += nodes;
+
+            std::cout << (nodes == expected ? "ok   " : "FAIL ") << test.name << " depth "
+                      << depth << " nodes " << nodes;
+            if (nodes != expected) {
+                std::cout << " expected " << expected;
+                passed = false;
+            }
+            std::cout << " nps " << static_cast<std::uint64_t>(nodes / seconds) << std::endl;
+        }
+    }
+
+    double seconds = secondsSince(suiteStart);
+    std::cout << (passed ? "All passed" : "Some positions FAILED") << ", " << totalNodes
+              << " nodes in " << seconds * 1000 << "ms, "
+              << static_cast<std::uint64_t>(totalNodes / seconds) << " nps" << std::endl;
+    return passed;
+}
+
+void printUsage() {
+    std::cout << "usage: perft <depth> [fen]    divide the position to depth, start position by default"
+              << std::endl
+              << "       perft --suite [depth]  check the reference positions, up to depth if given"
+              << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    if (command == "--suite") {
+        return runSuite(argc > 2 ? std::atoi(argv[2]) : 64) ? 0 : 1;
+    }
+
+    int depth = std::atoi(argv[1]);
+    if (depth < 1) {
+        printUsage();
+        return 1;
+    }
+
+    // FEN fields may arrive as separate arguments
+    std::string fen = startFen;
+    if (argc > 2) {
+        fen = argv[2];
+        for (int i = 3; i < argc; i++) {
+            fen += ' ';
+            fen += argv[i];
+        }
+    }
+
+    Position position;
+    if (!position.setFen(fen)) {
+        std::cout << "Invalid FEN: " << fen << std::endl;
+        return 1;
+    }
+    divide(position, depth);
+    return 0;
+}
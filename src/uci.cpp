@@ -0,0 +1,285 @@
+#include "Engine.hpp"
+#include "Notation.hpp"
+#include "Opponent.hpp"
+#include "Position.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Search callbacks write from the engine thread, so every line goes through
+// one lock to keep lines whole
+std::mutex outputMutex;
+
+void send(const std::string &line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
+}
+
+// Side to move when the current search started, search scores are from
+// black's point of view but UCI wants them from the side to move's
+pieceColor searchSide = pieceColor::white;
+
+// UCI score field. Pawns are worth 10 in the evaluation and 100 centipawns
+// in UCI. Mates are scored less the further away they are, which gives the
+// distance in plies
+std::string scoreText(const SearchResult &result) {
+    float score = searchSide == pieceColor::black ? result.score : -result.score;
+    if (std::abs(score) >= mateThreshold) {
+        int plies = static_cast<int>(std::lround(mateScore - std::abs(score)));
+        int moves = (plies + 1) / 2;
+        return "mate " + std::to_string(score > 0 ? moves : -moves);
+    }
+    return "cp " + std::to_string(static_cast<int>(std::lround(score * 10)));
+}
+
+void sendInfo(const SearchResult &result) {
+    std::uint64_t time = std::max<std::uint64_t>(result.elapsed.count(), 1);
+    std::ostringstream line;
+    line << "info depth " << result.depth << " score " << scoreText(result) << " nodes "
+         << result.nodes << " nps " << result.nodes * 1000 / time << " time "
+         << result.elapsed.count() << " hashfull " << getTranspositionTable().hashfull()
+         << " pv";
+    for (auto move : result.principalVariation) {
+        line << ' ' << moveToUci(move);
+    }
+    send(line.str());
+}
+
+void sendBestMove(const SearchResult &result) {
+    send("bestmove " + moveToUci(result.bestMove));
+}
+
+// position [startpos | fen <fen>] [moves <move>...]
+void setPosition(Position &position, std::istringstream &command) {
+    std::string token;
+    command >> token;
+    if (token == "startpos") {
+        position.resetPosition();
+        command >> token;
+    } else if (token == "fen") {
+        std::string fen;
+        while (command >> token && token != "moves") {
+            fen += token + " ";
+        }
+        if (!position.setFen(fen)) {
+            send("info string invalid fen " + fen);
+            return;
+        }
+    }
+
+    if (token != "moves") {
+        return;
+    }
+    while (command >> token) {
+        Move move = moveFromUci(position, token);
+        if (move == noMove) {
+            send("info string illegal move " + token);
+            return;
+        }
+        UndoInfo undo;
+        position.makeMove(move, undo);
+    }
+}
+
+// go [depth n] [movetime ms] [nodes n] [wtime ms btime ms winc ms binc ms
+// movestogo n] [infinite]. Without any limit the search runs until stop, and
+// bestmove isn't sent before it even if the search ends sooner
+SearchLimits parseGo(const Position &position, std::istringstream &command, int threads) {
+    SearchLimits limits;
+    limits.moveTime = std::chrono::milliseconds(0);
+    limits.threads = threads;
+
+    long long time[2] = {0, 0};
+    long long increment[2] = {0, 0};
+    long long movesToGo = 30;
+    bool hasClock = false;
+    bool hasMoveTime = false;
+    bool hasLimit = false;
+
+    std::string token;
+    while (command >> token) {
+        long long value = 0;
+        // Analysis wants a searched score, not a book move
+        if (token == "infinite") {
+            limits.useBook = false;
+            limits.infinite = true;
+            continue;
+        }
+        if (!(command >> value)) {
+            break;
+        }
+        hasLimit |= token == "depth" || token == "movetime" || token == "nodes" ||
+                    token == "wtime" || token == "btime";
+        if (token == "depth") {
+            limits.maxDepth = std::clamp<int>(value, 1, maxPly / 2);
+        } else if (token == "movetime") {
+            limits.moveTime = std::chrono::milliseconds(value);
+            hasMoveTime = true;
+        } else if (token == "nodes") {
+            limits.maxNodes = value;
+        } else if (token == "wtime" || token == "btime") {
+            time[token == "btime"] = value;
+            hasClock = true;
+        } else if (token == "winc" || token == "binc") {
+            increment[token == "binc"] = value;
+        } else if (token == "movestogo" && value > 0) {
+            movesToGo = value;
+        }
+    }
+
+    // Spend an even share of the clock plus most of the increment, always
+    // leaving a margin for communication delays
+    if (hasClock && !hasMoveTime) {
+        int side = colorIndex(position.getSideToMove());
+        long long budget = time[side] / movesToGo + increment[side] * 3 / 4;
+        budget = std::min(budget, time[side] - 50);
+        limits.moveTime = std::chrono::milliseconds(std::max(budget, 1LL));
+    }
+    if (!hasLimit) {
+        limits.infinite = true;
+    }
+    return limits;
+}
+
+// Search the start position to a fixed depth with and without move ordering
+// and report how many nodes each took
+void benchMoveOrdering(int depth) {
+    Position position;
+    position.resetPosition();
+    for (bool orderMoves : {false, true}) {
+        SearchLimits limits;
+        limits.maxDepth = depth;
+        limits.moveTime = std::chrono::milliseconds(0);
+        limits.orderMoves = orderMoves;
+        limits.useBook = false;
+        getTranspositionTable().clear();
+        auto result = searchPosition(position, limits);
+        std::ostringstream line;
+        line << "info string " << (orderMoves ? "ordered" : "unordered") << " depth "
+             << result.depth << " nodes " << result.nodes << " time "
+             << result.elapsed.count() << "ms";
+        send(line.str());
+    }
+}
+
+// Time the same fixed depth search with 1, 2, 4... threads up to maxThreads
+// and report the speedup over one thread
+void benchThreads(int depth, int maxThreads) {
+    Position position;
+    position.resetPosition();
+    double singleThreadTime = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        SearchLimits limits;
+        limits.maxDepth = depth;
+        limits.moveTime = std::chrono::milliseconds(0);
+        limits.threads = threads;
+        limits.useBook = false;
+        getTranspositionTable().clear();
+        auto start = std::chrono::steady_clock::now();
+        auto result = searchPosition(position, limits);
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1) {
+            singleThreadTime = time;
+        }
+        std::ostringstream line;
+        line << "info string threads " << threads << " depth " << result.depth << " nodes "
+             << result.nodes << " time " << time * 1000 << "ms speedup "
+             << singleThreadTime / time;
+        send(line.str());
+    }
+}
+
+// bench [depth] [threads], search statistics at depth 6 by default and up
+// to the Threads option
+void bench(std::istringstream &command, int threads) {
+    int depth = 6;
+    int value = 0;
+    if (command >> value) {
+        depth = std::clamp(value, 1, maxPly / 2);
+        if (command >> value) {
+            threads = value;
+        }
+    }
+    benchMoveOrdering(depth);
+    benchThreads(depth, std::max(threads, 1));
+}
+
+int main(int argc, char *argv[]) {
+    Position position;
+    position.resetPosition();
+    int threads = 1;
+    Engine engine(sendInfo, sendBestMove);
+
+    // uci bench [depth] [threads] runs the benchmark without a GUI and exits
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        std::string arguments;
+        for (int i = 2; i < argc; i++) {
+            arguments += std::string(argv[i]) + " ";
+        }
+        std::istringstream command(arguments);
+        bench(command, threads);
+        return 0;
+    }
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream command(line);
+        std::string token;
+        command >> token;
+
+        if (token == "uci") {
+            send("id name C++ Chess");
+            send("id author sami-hatna66");
+            send("option name Hash type spin default 16 min 1 max 4096");
+            send("option name Threads type spin default 1 min 1 max 256");
+            send("option name BookFile type string default <empty>");
+            send("uciok");
+        } else if (token == "isready") {
+            send("readyok");
+        } else if (token == "setoption") {
+            // setoption name <id> value <x>, the value may contain spaces
+            std::string name, value;
+            command >> token >> name >> token;
+            std::getline(command >> std::ws, value);
+            engine.cancel();
+            if (name == "Hash") {
+                getTranspositionTable().resize(std::clamp(std::atoi(value.c_str()), 1, 4096));
+            } else if (name == "Threads") {
+                threads = std::clamp(std::atoi(value.c_str()), 1, 256);
+            } else if (name == "BookFile") {
+                getOpeningBook().close();
+                if (value != "<empty>" && !value.empty() && !getOpeningBook().open(value)) {
+                    send("info string can't open book " + value);
+                }
+            }
+        } else if (token == "ucinewgame") {
+            engine.cancel();
+            getTranspositionTable().clear();
+        } else if (token == "position") {
+            engine.cancel();
+            setPosition(position, command);
+        } else if (token == "go") {
+            SearchLimits limits = parseGo(position, command, threads);
+            engine.cancel();
+            searchSide = position.getSideToMove();
+            engine.start(position, limits);
+        } else if (token == "stop") {
+            engine.stop();
+            engine.wait();
+        } else if (token == "bench") {
+            engine.cancel();
+            bench(command, threads);
+        } else if (token == "quit") {
+            break;
+        }
+    }
+
+    engine.cancel();
+    return 0;
+}